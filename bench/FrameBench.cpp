@@ -0,0 +1,646 @@
+// 无窗口固定负载帧基准测试
+// 构建确定性的场景（N只猫、M块地面、K个光源），沿固定相机路径离屏渲染固定帧数，
+// 以JSON输出每帧CPU/GPU耗时分布、绘制调用数、顶点数和上传字节数，用于比较改动和发现性能回退。
+//
+// 用法: pixelart3d_bench [--cats N] [--tiles M] [--lights K] [--frames F] [--warmup W]
+//                        [--width W] [--height H] [--readback] [--gpu-resident]
+//                        [--mesh-cache dir] [--animate] [--animation-rate R]
+//                        [--pixelate S] [--outline] [--quantize] [--dither] [--lut-size N] [--no-fuse]
+//                        [--resize-step P] [--pool-bucket B] [--target-ms T]
+//                        [--out file.json]
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Shader.h"
+#include "Camera.h"
+#include "Model.h"
+#include "RenderTargetPool.h"
+#include "DynamicResolution.h"
+#include "GpuProfiler.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "MemoryTracker.h"
+#include "MeshCache.h"
+#include "PartTransforms.h"
+#include "Scene.h"
+#include "RenderQueue.h"
+#include "GLState.h"
+#include "Animation.h"
+#include "BuiltinModels.h"
+#include "PostChain.h"
+#include "PaletteLut.h"
+
+namespace {
+
+// fragment.glsl中的MAX_LIGHTS
+const int MAX_LIGHTS = 4;
+const float TILE_SIZE = 10.0f;
+
+struct BenchConfig {
+    int cats = 100;
+    int tiles = 16;
+    int lights = 4;
+    int frames = 300;
+    int warmup = 30;
+    int width = 1280;
+    int height = 720;
+    bool readback = false;
+    bool gpuResident = false;
+    bool animate = false;
+    float animationRate = 60.0f;
+    int pixelate = 0;
+    bool outline = false;
+    bool quantize = false;
+    bool dither = false;
+    int lutSize = PaletteLut::DEFAULT_SIZE;
+    bool fuse = true;
+    int resizeStep = 0;
+    int poolBucket = RenderTargetPool::BUCKET;
+    double targetMs = 0.0;
+    std::string meshCache;
+    std::string output;
+};
+
+struct Distribution {
+    double min = 0.0;
+    double avg = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+struct BenchLight {
+    glm::vec3 position;
+    glm::vec3 color;
+};
+
+double nowMs() {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 固定种子的线性同余随机数，保证每次运行场景一致
+struct Lcg {
+    uint32_t state;
+    explicit Lcg(uint32_t seed) : state(seed) {}
+    float next() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+    }
+};
+
+bool parseArgs(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--readback") {
+            config.readback = true;
+        }
+        else if (arg == "--gpu-resident") {
+            config.gpuResident = true;
+        }
+        else if (arg == "--animate") {
+            config.animate = true;
+        }
+        else if (arg == "--outline") {
+            config.outline = true;
+        }
+        else if (arg == "--no-fuse") {
+            config.fuse = false;
+        }
+        else if (arg == "--quantize") {
+            config.quantize = true;
+        }
+        else if (arg == "--dither") {
+            config.quantize = true;
+            config.dither = true;
+        }
+        else if (arg == "--target-ms" && hasValue) {
+            config.targetMs = std::max(0.0, std::atof(argv[++i]));
+        }
+        else if (arg == "--animation-rate" && hasValue) {
+            config.animationRate = static_cast<float>(std::atof(argv[++i]));
+        }
+        else if (arg == "--mesh-cache" && hasValue) {
+            config.meshCache = argv[++i];
+        }
+        else if (arg == "--out" && hasValue) {
+            config.output = argv[++i];
+        }
+        else if (hasValue && (arg == "--cats" || arg == "--tiles" || arg == "--lights" ||
+                              arg == "--frames" || arg == "--warmup" || arg == "--width" ||
+                              arg == "--height" || arg == "--pixelate" || arg == "--lut-size" ||
+                              arg == "--resize-step" || arg == "--pool-bucket")) {
+            int value = std::atoi(argv[++i]);
+            if (arg == "--cats") config.cats = std::max(0, value);
+            else if (arg == "--tiles") config.tiles = std::max(1, value);
+            else if (arg == "--lights") config.lights = std::max(1, value);
+            else if (arg == "--frames") config.frames = std::max(1, value);
+            else if (arg == "--warmup") config.warmup = std::max(0, value);
+            else if (arg == "--width") config.width = std::max(1, value);
+            else if (arg == "--height") config.height = std::max(1, value);
+            else if (arg == "--pixelate") config.pixelate = std::max(0, value);
+            else if (arg == "--lut-size") config.lutSize = std::max(2, std::min(256, value));
+            else if (arg == "--resize-step") config.resizeStep = std::max(0, value);
+            else if (arg == "--pool-bucket") config.poolBucket = std::max(1, value);
+        }
+        else {
+            std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (config.lights > MAX_LIGHTS) {
+        std::cerr << "Warning: clamping lights to " << MAX_LIGHTS << std::endl;
+        config.lights = MAX_LIGHTS;
+    }
+    return true;
+}
+
+Distribution summarize(std::vector<double> samples) {
+    Distribution dist;
+    if (samples.empty()) {
+        return dist;
+    }
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double v : samples) {
+        sum += v;
+    }
+    auto percentile = [&samples](double p) {
+        size_t index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[std::min(index, samples.size() - 1)];
+    };
+    dist.min = samples.front();
+    dist.avg = sum / static_cast<double>(samples.size());
+    dist.p50 = percentile(0.50);
+    dist.p95 = percentile(0.95);
+    dist.p99 = percentile(0.99);
+    dist.max = samples.back();
+    return dist;
+}
+
+// GLFW要通过显示服务器创建（隐藏的）窗口才能拿到上下文；没有显示服务器时提示用xvfb-run
+void printDisplayHint() {
+#if !defined(_WIN32) && !defined(__APPLE__)
+    if (std::getenv("DISPLAY") == nullptr && std::getenv("WAYLAND_DISPLAY") == nullptr) {
+        std::cerr << "No display server (DISPLAY is not set); run the benchmark under a virtual X server:" << std::endl
+                  << "  xvfb-run -a ./pixelart3d_bench [options]" << std::endl;
+    }
+#endif
+}
+
+void writeDistribution(std::ostream& out, const Distribution& dist) {
+    out << "{\"min\":" << dist.min << ",\"avg\":" << dist.avg << ",\"p50\":" << dist.p50
+        << ",\"p95\":" << dist.p95 << ",\"p99\":" << dist.p99 << ",\"max\":" << dist.max << "}";
+}
+
+}
+
+// 在当前GL上下文中构建场景、运行并输出结果；着色器、场景、后处理、渲染目标和计时查询都是这里的局部变量
+int runBenchmark(const BenchConfig& config) {
+    Shader shader("shaders/vertex.glsl", "shaders/fragment.glsl");
+    shader.bindUniformBlock("PartTransforms", PartTransforms::BINDING);
+    shader.bindUniformBlock("Materials", MaterialTable::BINDING);
+    shader.use();
+    shader.setInt("palette", PaletteAtlas::TEXTURE_UNIT);
+
+    // 构建场景
+    if (config.gpuResident) {
+        Model::defaultResidency = Model::Residency::GpuOnly;
+    }
+    std::unique_ptr<MeshCache> meshCache;
+    if (!config.meshCache.empty()) {
+        meshCache = std::make_unique<MeshCache>(config.meshCache);
+        MeshCache::setDefault(meshCache.get());
+    }
+    double loadStart = nowMs();
+    RenderStats::get().reset();
+
+    int tileSide = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(config.tiles))));
+    float extent = tileSide * TILE_SIZE;
+    float origin = -extent * 0.5f + TILE_SIZE * 0.5f;
+
+    // 地面两种颜色交替，所有猫共用一个网格，实例只有变换不同
+    std::unique_ptr<Scene> sceneStorage = std::make_unique<Scene>();
+    Scene& scene = *sceneStorage;
+    Scene::MaterialId groundMaterial =
+        scene.addMaterial(Material(glm::vec3(0.2f), glm::vec3(0.8f), glm::vec3(0.2f), 16.0f));
+    Scene::MaterialId catMaterial =
+        scene.addMaterial(Material(glm::vec3(0.3f), glm::vec3(0.8f), glm::vec3(0.5f), 32.0f));
+    // 棋盘格的两种颜色共用一个地面网格，只换调色板
+    Scene::MeshId groundMesh = scene.addMesh(Model::createGround(TILE_SIZE, TILE_SIZE, glm::vec3(0.4f, 0.8f, 0.4f)));
+    Scene::PaletteId groundPalettes[2] = {
+        scene.getMeshPalette(groundMesh),
+        scene.addPalette({glm::vec3(0.35f, 0.7f, 0.35f)})
+    };
+    for (int i = 0; i < config.tiles; i++) {
+        int tx = i % tileSide;
+        int tz = i / tileSide;
+        Scene::EntityId tile = scene.createEntity(groundMesh, groundMaterial,
+                                                  glm::vec3(origin + tx * TILE_SIZE, -0.5f, origin + tz * TILE_SIZE));
+        scene.setPalette(tile, groundPalettes[(tx + tz) % 2]);
+    }
+
+    Scene::MeshId catMesh = scene.addMesh(Model::createCat(glm::vec3(0.0f), 1.0f));
+    Scene::PaletteId catCoats[BuiltinModels::CatCoatCount];
+    catCoats[BuiltinModels::CatCoatGray] = scene.getMeshPalette(catMesh);
+    for (int coat = BuiltinModels::CatCoatGray + 1; coat < BuiltinModels::CatCoatCount; coat++) {
+        catCoats[coat] = scene.addPalette(BuiltinModels::catPalette(static_cast<BuiltinModels::CatCoat>(coat)));
+    }
+    std::vector<Scene::EntityId> cats;
+    Lcg rng(12345u);
+    int catSide = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(config.cats)))));
+    float spacing = extent / catSide;
+    for (int i = 0; i < config.cats; i++) {
+        float jitterX = (rng.next() - 0.5f) * spacing * 0.3f;
+        float jitterZ = (rng.next() - 0.5f) * spacing * 0.3f;
+        glm::vec3 position(-extent * 0.5f + spacing * (i % catSide + 0.5f) + jitterX,
+                           0.0f,
+                           -extent * 0.5f + spacing * (i / catSide + 0.5f) + jitterZ);
+        cats.push_back(scene.createEntity(catMesh, catMaterial, position));
+        scene.setPalette(cats.back(), catCoats[i % BuiltinModels::CatCoatCount]);
+    }
+
+    // --animate时一半猫待机、一半行走，相位随机；相同的姿态共用一组部件矩阵，每帧只上传不同的姿态
+    AnimationSampler animation(Skeleton::createCat(), config.animationRate);
+    animation.addClip(AnimationClip::createCatIdle());
+    animation.addClip(AnimationClip::createCatWalk());
+    std::vector<AnimationSampler::Instance> catAnimations;
+    std::vector<float> catPhases;
+    for (int i = 0; i < config.cats; i++) {
+        catAnimations.push_back(AnimationSampler::Instance{
+            static_cast<unsigned int>(i % animation.getClipCount()), 0.0f});
+        catPhases.push_back(rng.next() * 2.0f);
+    }
+    int animationFrame = 0;
+    uint64_t animationPoses = 0;
+    uint64_t visibleEntities = 0;
+    RenderQueue renderQueue;
+    uint64_t materialChanges = 0;
+    uint64_t meshChanges = 0;
+    uint64_t poseChanges = 0;
+    uint64_t paletteChanges = 0;
+
+    std::vector<BenchLight> lights;
+    for (int i = 0; i < config.lights; i++) {
+        float angle = glm::radians(360.0f * i / config.lights + 45.0f);
+        BenchLight light;
+        light.position = glm::vec3(std::cos(angle) * extent * 0.4f, 8.0f, std::sin(angle) * extent * 0.4f);
+        light.color = glm::vec3(1.0f / config.lights + 0.25f);
+        lights.push_back(light);
+    }
+
+    double loadMs = nowMs() - loadStart;
+    uint64_t loadUploadedBytes = RenderStats::get().uploadedBytes;
+    size_t modelCpuBytes = 0;
+    size_t modelGpuBytes = 0;
+    for (Scene::MeshId mesh = 0; mesh < scene.getMeshCount(); mesh++) {
+        modelCpuBytes += scene.getMesh(mesh).cpuMemoryBytes();
+        modelGpuBytes += scene.getMesh(mesh).gpuMemoryBytes();
+    }
+
+    // 固定相机路径：轨道相机在测量阶段绕场景转一整圈
+    Camera camera(extent * 0.6f + 8.0f);
+    float yawStep = 360.0f / config.frames;
+    float farPlane = camera.Radius * 3.0f + extent;
+
+    // 离屏目标每帧从池中借用；--resize-step模拟拖动窗口放大：每帧宽高增加P像素，16帧后回到最小再重复，
+    // --pool-bucket 1时按精确尺寸分配，相当于每次尺寸变化都重建目标
+    RenderTargetPool renderTargets(config.poolBucket);
+    int resizeFrame = 0;
+
+    // --target-ms开启动态分辨率：测量阶段按GPU耗时调整场景分辨率，除数取像素块大小的约数
+    DynamicResolution dynamicResolution(std::max(1, config.pixelate), config.targetMs);
+    dynamicResolution.setEnabled(config.targetMs > 0.0);
+    uint64_t divisorSum = 0;
+
+    // 后处理链：像素化（--pixelate）、描边（--outline）、抖动和调色板量化（--dither/--quantize），
+    // 输出到离屏帧缓冲；--no-fuse时每个阶段单独一个通道
+    bool post = config.pixelate > 0 || config.outline || config.quantize;
+    PostChain postChain(renderTargets);
+    PaletteLut paletteLut;
+    if (post) {
+        float block = static_cast<float>(std::max(1, config.pixelate));
+        postChain.addStage("pixelate", PostChain::StageKind::Sample, "shaders/post/pixelate.glsl");
+        postChain.addStage("outline", PostChain::StageKind::Sample, "shaders/post/outline.glsl");
+        postChain.addStage("dither", PostChain::StageKind::Color, "shaders/post/dither.glsl");
+        postChain.addStage("quantize", PostChain::StageKind::Color, "shaders/post/quantize.glsl");
+        postChain.setEnabled("pixelate", config.pixelate > 0);
+        postChain.setEnabled("outline", config.outline);
+        postChain.setEnabled("dither", config.dither);
+        postChain.setEnabled("quantize", config.quantize);
+        postChain.setFusion(config.fuse);
+        postChain.setFloat("outline_threshold", 0.15f);
+        postChain.setVec3("outline_color", glm::vec3(0.1f, 0.1f, 0.15f));
+        postChain.setFloat("dither_strength", 0.12f);
+        postChain.setFloat("dither_scale", block);
+        postChain.setInt("quantize_lut", PaletteLut::LUT_TEXTURE_UNIT);
+        postChain.setInt("quantize_palette", PaletteLut::PALETTE_TEXTURE_UNIT);
+        postChain.setInt("quantize_lutSize", config.lutSize);
+        if (config.quantize) {
+            paletteLut.build(PaletteLut::createPico8(), static_cast<unsigned int>(config.lutSize));
+        }
+    }
+    RenderTargetPool::Target postTarget;
+    std::vector<unsigned char> pixels;
+    if (config.readback) {
+        pixels.resize(static_cast<size_t>(config.width) * config.height * 3);
+        MemoryTracker::get().record(MemoryTracker::Resource::Cpu, reinterpret_cast<uintptr_t>(&pixels),
+                                    MemoryCategory::Capture, &pixels, "readback", pixels.size());
+    }
+
+    auto renderFrame = [&](GpuProfiler* profiler) {
+        PROFILE_SCOPE("benchFrame");
+        if (profiler) {
+            profiler->beginFrame();
+            profiler->beginPass("scene");
+        }
+
+        int shrink = config.resizeStep * (15 - resizeFrame++ % 16);
+        int width = std::max(1, config.width - shrink);
+        int height = std::max(1, config.height - shrink);
+        RenderTargetPool::Target target = renderTargets.acquire(
+            {dynamicResolution.scale(width), dynamicResolution.scale(height), GL_RGB, true});
+        target.bind();
+        GLState::get().setEnabled(GL_DEPTH_TEST, true);
+        glClearColor(0.7f, 0.9f, 1.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        shader.use();
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f),
+                                                (float)width / (float)height, 0.1f, farPlane);
+        glm::mat4 view = camera.GetViewMatrix();
+        shader.setMat4("projection", projection);
+        shader.setMat4("view", view);
+        shader.setVec3("viewPos", camera.Position);
+
+        shader.setInt("numLights", static_cast<int>(lights.size()));
+        for (size_t i = 0; i < lights.size(); i++) {
+            std::string prefix = "lights[" + std::to_string(i) + "].";
+            shader.setVec3(prefix + "position", lights[i].position);
+            shader.setVec3(prefix + "ambient", lights[i].color * 0.3f);
+            shader.setVec3(prefix + "diffuse", lights[i].color);
+            shader.setVec3(prefix + "specular", lights[i].color);
+            shader.setFloat(prefix + "constant", 1.0f);
+            shader.setFloat(prefix + "linear", 0.014f);
+            shader.setFloat(prefix + "quadratic", 0.0007f);
+        }
+
+        if (config.animate) {
+            float animationTime = animationFrame++ / 60.0f;
+            for (size_t i = 0; i < catAnimations.size(); i++) {
+                catAnimations[i].time = animationTime + catPhases[i];
+            }
+            animation.evaluate(catAnimations.data(), catAnimations.size());
+            for (size_t pose = 0; pose < animation.getPoseCount(); pose++) {
+                scene.getPoseBuffer(static_cast<uint32_t>(pose))
+                    .set(animation.getPose(pose), BuiltinModels::CatPartCount);
+            }
+            for (size_t i = 0; i < cats.size(); i++) {
+                scene.setPose(cats[i], animation.getPoseIndex(i));
+            }
+            animationPoses += animation.getPoseCount();
+        }
+
+        scene.updateTransforms();
+        visibleEntities += scene.cull(projection * view);
+        renderQueue.clear(farPlane);
+        scene.submit(renderQueue, shader, camera.Position);
+        renderQueue.sort();
+        renderQueue.submit();
+        materialChanges += renderQueue.getStats().materialChanges;
+        meshChanges += renderQueue.getStats().meshChanges;
+        poseChanges += renderQueue.getStats().poseChanges;
+        paletteChanges += renderQueue.getStats().paletteChanges;
+
+        if (profiler) {
+            profiler->endPass();
+        }
+
+        if (post) {
+            if (profiler) {
+                profiler->beginPass("post");
+            }
+            if (config.quantize) {
+                paletteLut.bind();
+            }
+            float block = static_cast<float>(std::max(1, config.pixelate));
+            glm::vec2 pixelBlock(block / width, block / height);
+            postChain.setVec2("pixelate_size", pixelBlock);
+            postChain.setVec2("outline_step", pixelBlock);
+            postTarget = renderTargets.acquire({width, height, GL_RGB, false});
+            postChain.run(target, postTarget.framebuffer->FBO, width, height);
+            if (profiler) {
+                profiler->endPass();
+            }
+        }
+
+        if (config.readback) {
+            if (profiler) {
+                profiler->beginPass("readback");
+            }
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            // 没有后处理时回读的是（可能降低了分辨率的）场景目标
+            int readWidth = post ? width : target.width;
+            int readHeight = post ? height : target.height;
+            glReadPixels(0, 0, readWidth, readHeight, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+            if (profiler) {
+                profiler->endPass();
+            }
+        }
+
+        GLState::get().bindFramebuffer(0);
+        renderTargets.release(target);
+        if (post) {
+            renderTargets.release(postTarget);
+        }
+        renderTargets.endFrame();
+        if (profiler) {
+            profiler->endFrame();
+        }
+    };
+
+    // 预热：让驱动完成着色器编译和资源驻留
+    for (int i = 0; i < config.warmup; i++) {
+        renderFrame(nullptr);
+    }
+    glFinish();
+    animationPoses = 0;
+    visibleEntities = 0;
+    materialChanges = 0;
+    meshChanges = 0;
+    poseChanges = 0;
+    paletteChanges = 0;
+
+    GpuProfiler gpuProfiler;
+    std::vector<double> cpuMs;
+    std::vector<double> frameMs;
+    uint64_t drawCalls = 0;
+    uint64_t vertices = 0;
+    uint64_t uploadedBytes = 0;
+    uint64_t stateCalls = 0;
+    uint64_t stateCallsAvoided = 0;
+
+    for (int i = 0; i < config.frames; i++) {
+        camera.RotateLeft(yawStep / camera.RotationSpeed);
+        RenderStats::get().reset();
+
+        double frameStart = nowMs();
+        renderFrame(&gpuProfiler);
+        double submitted = nowMs();
+        glFinish();
+        double finished = nowMs();
+
+        cpuMs.push_back(submitted - frameStart);
+        frameMs.push_back(finished - frameStart);
+        divisorSum += dynamicResolution.getDivisor();
+        dynamicResolution.update(gpuProfiler.getLastMs("scene"), gpuProfiler.getLastMs("post"));
+        const RenderStats& stats = RenderStats::get();
+        drawCalls += stats.drawCalls;
+        vertices += stats.vertices;
+        uploadedBytes += stats.uploadedBytes;
+        stateCalls += stats.stateCalls;
+        stateCallsAvoided += stats.stateCallsAvoided;
+    }
+    gpuProfiler.flush();
+
+    // 输出JSON
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(4);
+    json << "{\n";
+    json << "  \"config\": {\"cats\":" << config.cats << ",\"tiles\":" << config.tiles
+         << ",\"lights\":" << config.lights << ",\"frames\":" << config.frames
+         << ",\"warmup\":" << config.warmup << ",\"width\":" << config.width
+         << ",\"height\":" << config.height << ",\"readback\":" << (config.readback ? "true" : "false")
+         << ",\"gpu_resident\":" << (config.gpuResident ? "true" : "false")
+         << ",\"animate\":" << (config.animate ? "true" : "false")
+         << ",\"animation_rate\":" << config.animationRate
+         << ",\"mesh_cache\":" << (config.meshCache.empty() ? "false" : "true")
+         << ",\"pixelate\":" << config.pixelate << ",\"outline\":" << (config.outline ? "true" : "false")
+         << ",\"fuse\":" << (config.fuse ? "true" : "false") << ",\"quantize\":" << (config.quantize ? "true" : "false")
+         << ",\"dither\":" << (config.dither ? "true" : "false") << ",\"lut_size\":" << config.lutSize
+         << ",\"resize_step\":" << config.resizeStep << ",\"pool_bucket\":" << config.poolBucket
+         << ",\"target_ms\":" << config.targetMs << "},\n";
+    json << "  \"renderer\": \"" << reinterpret_cast<const char*>(glGetString(GL_RENDERER)) << "\",\n";
+    json << "  \"gpu_timing\": \""
+         << (gpuProfiler.getMode() == GpuProfiler::Mode::TimerQuery ? "timer_query" : "finish_fence") << "\",\n";
+    json << "  \"load\": {\"ms\":" << loadMs << ",\"meshes\":" << scene.getMeshCount()
+         << ",\"entities\":" << scene.getEntityCount()
+         << ",\"uploaded_bytes\":" << loadUploadedBytes << ",\"model_cpu_bytes\":" << modelCpuBytes
+         << ",\"model_gpu_bytes\":" << modelGpuBytes << ",\"lut_ms\":" << paletteLut.getBuildMs()
+         << ",\"lut_cached\":" << (paletteLut.wasCached() ? "true" : "false") << "},\n";
+    json << "  \"cpu_ms\": ";
+    writeDistribution(json, summarize(cpuMs));
+    json << ",\n  \"frame_ms\": ";
+    writeDistribution(json, summarize(frameMs));
+    json << ",\n  \"gpu_ms\": {";
+    std::vector<GpuProfiler::PassStats> passes = gpuProfiler.getStats();
+    for (size_t i = 0; i < passes.size(); i++) {
+        json << (i == 0 ? "" : ",") << "\"" << passes[i].name << "\":";
+        writeDistribution(json, summarize(gpuProfiler.getSamples(passes[i].name.c_str())));
+    }
+    json << "},\n";
+    json << "  \"per_frame\": {\"draw_calls\":" << static_cast<double>(drawCalls) / config.frames
+         << ",\"vertices\":" << static_cast<double>(vertices) / config.frames
+         << ",\"uploaded_bytes\":" << static_cast<double>(uploadedBytes) / config.frames
+         << ",\"visible_entities\":" << static_cast<double>(visibleEntities) / config.frames
+         << ",\"material_changes\":" << static_cast<double>(materialChanges) / config.frames
+         << ",\"mesh_changes\":" << static_cast<double>(meshChanges) / config.frames
+         << ",\"pose_changes\":" << static_cast<double>(poseChanges) / config.frames
+         << ",\"palette_changes\":" << static_cast<double>(paletteChanges) / config.frames
+         << ",\"post_passes\":" << (post ? postChain.getPassCount() : 0)
+         << ",\"post_bytes\":" << (post ? postChain.getBandwidthBytes() : 0)
+         << ",\"state_calls\":" << static_cast<double>(stateCalls) / config.frames
+         << ",\"state_calls_avoided\":" << static_cast<double>(stateCallsAvoided) / config.frames
+         << ",\"animation_poses\":" << static_cast<double>(animationPoses) / config.frames << "},\n";
+    const RenderTargetPool::Stats& targetStats = renderTargets.getStats();
+    json << "  \"render_targets\": {\"allocations\":" << targetStats.allocations
+         << ",\"reuses\":" << targetStats.reuses << ",\"evictions\":" << targetStats.evictions
+         << ",\"live_targets\":" << targetStats.liveTargets << ",\"live_bytes\":" << targetStats.liveBytes << "},\n";
+    json << "  \"dynamic_resolution\": {\"enabled\":" << (dynamicResolution.isEnabled() ? "true" : "false")
+         << ",\"avg_divisor\":" << static_cast<double>(divisorSum) / config.frames
+         << ",\"final_divisor\":" << dynamicResolution.getDivisor()
+         << ",\"changes\":" << dynamicResolution.getChanges() << "},\n";
+    json << "  \"memory\": {";
+    for (int i = 0; i < static_cast<int>(MemoryCategory::Count); i++) {
+        MemoryTracker::CategoryStats stats = MemoryTracker::get().getStats(static_cast<MemoryCategory>(i));
+        json << "\"" << MemoryTracker::categoryName(static_cast<MemoryCategory>(i)) << "\":{\"live\":"
+             << stats.liveBytes << ",\"peak\":" << stats.peakBytes << "},";
+    }
+    json << "\"total\":{\"live\":" << MemoryTracker::get().getLiveBytes()
+         << ",\"peak\":" << MemoryTracker::get().getPeakBytes() << "}}\n";
+    json << "}\n";
+
+    if (config.output.empty()) {
+        std::cout << json.str();
+    }
+    else {
+        std::ofstream file(config.output);
+        if (!file) {
+            std::cerr << "Failed to write " << config.output << std::endl;
+            return 1;
+        }
+        file << json.str();
+    }
+
+    PROFILE_DUMP("bench_cpu_trace.json");
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    PROFILE_THREAD_NAME("main");
+
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        return 1;
+    }
+
+    if (!glfwInit()) {
+        std::cerr << "Failed to initialize GLFW" << std::endl;
+        printDisplayHint();
+        return 1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    // 窗口只用于获取上下文，渲染全部在离屏帧缓冲中进行
+    GLFWwindow* window = glfwCreateWindow(64, 64, "PixelArt3D bench", nullptr, nullptr);
+    if (!window) {
+        std::cerr << "Failed to create GLFW window" << std::endl;
+        printDisplayHint();
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    if (glewInit() != GLEW_OK) {
+        std::cerr << "Failed to initialize GLEW" << std::endl;
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return 1;
+    }
+
+    // 持有GL对象的局部变量都在runBenchmark中，返回时随之释放，此时上下文仍然有效
+    int result = runBenchmark(config);
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return result;
+}
@@ -0,0 +1,461 @@
+// 模型构建热点的微基准测试
+// 覆盖addCube、createCat、createGround、setupMesh上传量和动画采样，报告每个方块（实例）的纳秒数、
+// 每个模型的堆分配次数（通过替换全局operator new统计）和每个顶点的字节数。
+// 新的网格生成器只需在main中再加一个runBench调用。
+//
+// 用法: pixelart3d_microbench [--min-time seconds] [--json file.json]
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <vector>
+#include "Model.h"
+#include "ModelBuilder.h"
+#include "VoxLoader.h"
+#include "MeshCache.h"
+#include "ModelDescription.h"
+#include "Animation.h"
+
+// ---- 分配计数 ----
+
+namespace {
+
+std::atomic<uint64_t> allocationCount{0};
+std::atomic<uint64_t> allocatedBytes{0};
+
+void* countedAlloc(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* countedAlignedAlloc(std::size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (size + align - 1) / align * align;
+    return std::aligned_alloc(align, rounded == 0 ? align : rounded);
+}
+
+}
+
+void* operator new(std::size_t size) {
+    void* p = countedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t size) {
+    void* p = countedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* p = countedAlignedAlloc(size, alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    void* p = countedAlignedAlloc(size, alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// ---- 测试框架 ----
+
+namespace {
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations = 0;
+    double nsPerIteration = 0.0;
+    double nsPerBox = 0.0;
+    double allocationsPerIteration = 0.0;
+    double allocatedBytesPerIteration = 0.0;
+    size_t boxes = 0;                // 每次迭代生成的方块数
+    size_t vertices = 0;             // 每次迭代生成的顶点数
+    size_t uploadBytes = 0;          // 每次迭代上传到GPU的字节数
+};
+
+// 单次迭代的产出，由被测函数返回
+struct BenchOutput {
+    size_t boxes;
+    size_t vertices;
+    size_t uploadBytes;
+};
+
+double minTimeSeconds = 0.25;
+const int REPETITIONS = 5;
+
+// 先试跑一次估算迭代次数，再重复REPETITIONS轮取中位数
+template <typename Body>
+BenchResult runBench(const std::string& name, Body body) {
+    BenchOutput output = body();
+
+    auto measure = [&body](uint64_t iterations, double& seconds, uint64_t& allocations, uint64_t& bytes) {
+        uint64_t allocStart = allocationCount.load(std::memory_order_relaxed);
+        uint64_t bytesStart = allocatedBytes.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; i++) {
+            body();
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        allocations = allocationCount.load(std::memory_order_relaxed) - allocStart;
+        bytes = allocatedBytes.load(std::memory_order_relaxed) - bytesStart;
+    };
+
+    uint64_t iterations = 1;
+    double seconds = 0.0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    while (true) {
+        measure(iterations, seconds, allocations, bytes);
+        if (seconds >= minTimeSeconds / REPETITIONS || iterations >= (1ull << 30)) {
+            break;
+        }
+        double scale = seconds > 0.0 ? (minTimeSeconds / REPETITIONS) / seconds : 10.0;
+        iterations = std::max<uint64_t>(iterations + 1,
+                                        static_cast<uint64_t>(iterations * std::min(scale * 1.2, 10.0)));
+    }
+
+    std::vector<double> nsPerIteration;
+    for (int r = 0; r < REPETITIONS; r++) {
+        measure(iterations, seconds, allocations, bytes);
+        nsPerIteration.push_back(seconds * 1.0e9 / static_cast<double>(iterations));
+    }
+    std::sort(nsPerIteration.begin(), nsPerIteration.end());
+
+    BenchResult result;
+    result.name = name;
+    result.iterations = iterations;
+    result.nsPerIteration = nsPerIteration[REPETITIONS / 2];
+    result.nsPerBox = output.boxes > 0 ? result.nsPerIteration / static_cast<double>(output.boxes) : 0.0;
+    result.allocationsPerIteration = static_cast<double>(allocations) / static_cast<double>(iterations);
+    result.allocatedBytesPerIteration = static_cast<double>(bytes) / static_cast<double>(iterations);
+    result.boxes = output.boxes;
+    result.vertices = output.vertices;
+    result.uploadBytes = output.uploadBytes;
+    return result;
+}
+
+void printResults(const std::vector<BenchResult>& results) {
+    std::cout << std::left << std::setw(22) << "benchmark" << std::right
+              << std::setw(14) << "ns/iter" << std::setw(10) << "ns/box"
+              << std::setw(12) << "allocs/iter" << std::setw(14) << "bytes/iter"
+              << std::setw(8) << "boxes" << std::setw(10) << "vertices"
+              << std::setw(12) << "upload B" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const BenchResult& r : results) {
+        std::cout << std::left << std::setw(22) << r.name << std::right
+                  << std::setw(14) << r.nsPerIteration << std::setw(10) << r.nsPerBox
+                  << std::setw(12) << r.allocationsPerIteration << std::setw(14) << r.allocatedBytesPerIteration
+                  << std::setw(8) << r.boxes << std::setw(10) << r.vertices
+                  << std::setw(12) << r.uploadBytes << std::endl;
+    }
+    std::cout << "bytes/vertex: " << sizeof(Vertex) << std::endl;
+}
+
+bool writeJson(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return false;
+    }
+    file << std::fixed << std::setprecision(3);
+    file << "{\n  \"bytes_per_vertex\": " << sizeof(Vertex) << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        file << "    {\"name\":\"" << r.name << "\",\"iterations\":" << r.iterations
+             << ",\"ns_per_iter\":" << r.nsPerIteration << ",\"ns_per_box\":" << r.nsPerBox
+             << ",\"allocs_per_iter\":" << r.allocationsPerIteration
+             << ",\"alloc_bytes_per_iter\":" << r.allocatedBytesPerIteration
+             << ",\"boxes\":" << r.boxes << ",\"vertices\":" << r.vertices
+             << ",\"upload_bytes\":" << r.uploadBytes << "}"
+             << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    file << "  ]\n}\n";
+    return true;
+}
+
+size_t uploadBytesOf(const Model& model) {
+    return model.gpuMemoryBytes();
+}
+
+void appendInt(std::vector<unsigned char>& out, int32_t value) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+void appendChunk(std::vector<unsigned char>& out, const char* id, const std::vector<unsigned char>& content,
+                 const std::vector<unsigned char>& children = std::vector<unsigned char>()) {
+    out.insert(out.end(), id, id + 4);
+    appendInt(out, static_cast<int32_t>(content.size()));
+    appendInt(out, static_cast<int32_t>(children.size()));
+    out.insert(out.end(), content.begin(), content.end());
+    out.insert(out.end(), children.begin(), children.end());
+}
+
+// 生成一个边长为size的实心球.vox文件（只有SIZE/XYZI块，使用内置调色板）
+std::vector<unsigned char> makeSphereVox(int size) {
+    std::vector<unsigned char> size_;
+    appendInt(size_, size);
+    appendInt(size_, size);
+    appendInt(size_, size);
+
+    std::vector<unsigned char> xyzi(4, 0);
+    float center = (size - 1) * 0.5f;
+    float radius = size * 0.5f;
+    int32_t count = 0;
+    for (int z = 0; z < size; z++) {
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                float dx = x - center, dy = y - center, dz = z - center;
+                if (dx * dx + dy * dy + dz * dz <= radius * radius) {
+                    unsigned char voxel[4] = {static_cast<unsigned char>(x), static_cast<unsigned char>(y),
+                                              static_cast<unsigned char>(z), static_cast<unsigned char>(1 + (x + y + z) % 8)};
+                    xyzi.insert(xyzi.end(), voxel, voxel + 4);
+                    count++;
+                }
+            }
+        }
+    }
+    std::memcpy(xyzi.data(), &count, 4);
+
+    std::vector<unsigned char> children;
+    appendChunk(children, "SIZE", size_);
+    appendChunk(children, "XYZI", xyzi);
+
+    std::vector<unsigned char> file = {'V', 'O', 'X', ' '};
+    appendInt(file, 150);
+    appendChunk(file, "MAIN", std::vector<unsigned char>(), children);
+    return file;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::string jsonPath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--min-time" && i + 1 < argc) {
+            minTimeSeconds = std::max(0.01, std::atof(argv[++i]));
+        }
+        else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    // createCat等工厂函数会上传网格，需要一个隐藏窗口提供GL上下文
+    if (!glfwInit()) {
+        std::cerr << "Failed to initialize GLFW" << std::endl;
+        return 1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "PixelArt3D microbench", nullptr, nullptr);
+    if (!window) {
+        std::cerr << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    if (glewInit() != GLEW_OK) {
+        std::cerr << "Failed to initialize GLEW" << std::endl;
+        return 1;
+    }
+
+    std::vector<BenchResult> results;
+
+    // 纯CPU：向空模型追加方块（不上传）
+    const size_t boxesPerModel = 64;
+    results.push_back(runBench("addCube x64", [&]() {
+        Model model;
+        for (size_t i = 0; i < boxesPerModel; i++) {
+            float f = static_cast<float>(i);
+            model.addCube(glm::vec3(f, 0.0f, -f), glm::vec3(1.0f, 0.5f, 0.25f), glm::vec3(0.6f));
+        }
+        return BenchOutput{boxesPerModel, model.vertices.size(), 0};
+    }));
+
+    // 构建器：记录方块后一次性写出顶点（不上传）
+    results.push_back(runBench("ModelBuilder x64", [&]() {
+        ModelBuilder builder;
+        builder.reserve(boxesPerModel);
+        for (size_t i = 0; i < boxesPerModel; i++) {
+            float f = static_cast<float>(i);
+            builder.addBox(glm::vec3(f, 0.0f, -f), glm::vec3(1.0f, 0.5f, 0.25f), glm::vec3(0.6f));
+        }
+        std::vector<Vertex> vertices;
+        builder.build(vertices);
+        return BenchOutput{builder.boxCount(), vertices.size(), 0};
+    }));
+
+    results.push_back(runBench("createCube", []() {
+        Model model = Model::createCube(glm::vec3(0.0f), glm::vec3(1.0f), glm::vec3(0.6f));
+        return BenchOutput{model.vertices.size() / 36, model.vertices.size(), uploadBytesOf(model)};
+    }));
+
+    results.push_back(runBench("createGround", []() {
+        Model model = Model::createGround(10.0f, 10.0f, glm::vec3(0.4f, 0.8f, 0.4f));
+        return BenchOutput{model.vertices.size() / 36, model.vertices.size(), uploadBytesOf(model)};
+    }));
+
+    results.push_back(runBench("createCat", []() {
+        Model model = Model::createCat(glm::vec3(0.0f), 1.0f);
+        return BenchOutput{model.vertices.size() / 36, model.vertices.size(), uploadBytesOf(model)};
+    }));
+
+    // 不在原点的猫不能使用烘焙顶点，走构建器
+    results.push_back(runBench("createCat (placed)", []() {
+        Model model = Model::createCat(glm::vec3(1.0f, 0.0f, 2.0f), 1.0f);
+        return BenchOutput{model.vertices.size() / 36, model.vertices.size(), uploadBytesOf(model)};
+    }));
+
+    // GPU驻留：顶点直接写入映射的缓冲，不保留CPU副本
+    results.push_back(runBench("createCat (GpuOnly)", []() {
+        Model::defaultResidency = Model::Residency::GpuOnly;
+        Model model = Model::createCat(glm::vec3(0.0f), 1.0f);
+        Model::defaultResidency = Model::Residency::CpuAndGpu;
+        return BenchOutput{model.vertexCount / 36, model.vertexCount, uploadBytesOf(model)};
+    }));
+
+    // 只测上传：复用已生成的顶点，重复setupMesh
+    Model catSource = Model::createCat(glm::vec3(0.0f), 1.0f);
+    results.push_back(runBench("setupMesh (cat)", [&catSource]() {
+        Model model;
+        model.vertices = catSource.vertices;
+        model.setupMesh();
+        return BenchOutput{model.vertices.size() / 36, model.vertices.size(), uploadBytesOf(model)};
+    }));
+
+    // 文本模型描述：解析（含部件去重）与按部件实例化生成
+    std::ifstream catFile("models/cat.model", std::ios::binary);
+    std::string catText((std::istreambuf_iterator<char>(catFile)), std::istreambuf_iterator<char>());
+    ModelDescription catDescription;
+    std::string parseError;
+    if (catDescription.parse(catText.data(), catText.size(), parseError)) {
+        results.push_back(runBench("Description parse (cat)", [&]() {
+            ModelDescription description;
+            std::string error;
+            description.parse(catText.data(), catText.size(), error);
+            return BenchOutput{description.boxCount(), 0, 0};
+        }));
+        results.push_back(runBench("Description build (cat)", [&]() {
+            Model model = catDescription.build();
+            return BenchOutput{catDescription.boxCount(), model.vertexCount, uploadBytesOf(model)};
+        }));
+    }
+    else {
+        std::cerr << "Skipping model description benchmarks: models/cat.model: " << parseError << std::endl;
+    }
+
+    // .vox：解析（只记录块位置）与剔除隐藏面的网格生成
+    std::vector<unsigned char> sphereVox = makeSphereVox(64);
+    VoxFile sphereFile;
+    sphereFile.openMemory(sphereVox.data(), sphereVox.size());
+    size_t sphereVoxels = sphereFile.getModels().empty() ? 0 : sphereFile.getModels()[0].voxelCount;
+    results.push_back(runBench("VoxFile parse 64^3", [&]() {
+        VoxFile file;
+        file.openMemory(sphereVox.data(), sphereVox.size());
+        return BenchOutput{file.getModels()[0].voxelCount, 0, 0};
+    }));
+    results.push_back(runBench("VoxMesher 64^3", [&]() {
+        std::vector<Vertex> vertices;
+        VoxMesher::mesh(sphereFile.getModels()[0], vertices);
+        return BenchOutput{sphereVoxels, vertices.size(), 0};
+    }));
+    results.push_back(runBench("VoxLoader 64^3", [&]() {
+        Model model;
+        VoxLoader::load(sphereFile, model, 0.1f, false);
+        return BenchOutput{sphereVoxels, model.vertexCount, uploadBytesOf(model)};
+    }));
+
+    // 网格缓存命中：映射缓存文件直接上传（先加载一次写入缓存）。
+    // 缓存放在本次运行独有的临时目录中，测完删除，不会测到之前运行留下的文件
+    std::error_code cacheError;
+    std::filesystem::path cacheDirectory =
+        MeshCache::temporaryPath((std::filesystem::temp_directory_path(cacheError) / "pixelart3d_microbench").string());
+    std::filesystem::remove_all(cacheDirectory, cacheError);
+    MeshCache benchCache(cacheDirectory.string());
+    MeshCache::setDefault(&benchCache);
+    {
+        Model warm;
+        VoxLoader::load(sphereFile, warm, 0.1f, false);
+    }
+    results.push_back(runBench("VoxLoader 64^3 (cached)", [&]() {
+        Model model;
+        VoxLoader::load(sphereFile, model, 0.1f, false);
+        return BenchOutput{sphereVoxels, model.vertexCount, uploadBytesOf(model)};
+    }));
+    MeshCache::setDefault(nullptr);
+    std::filesystem::remove_all(cacheDirectory, cacheError);
+
+    // 动画采样：1万只猫，一半待机一半行走，相位随机；每次迭代前进一帧
+    const size_t HERD_SIZE = 10000;
+    AnimationSampler sharedSampler(Skeleton::createCat());
+    AnimationSampler exactSampler(Skeleton::createCat(), 0.0f);
+    for (AnimationSampler* sampler : {&sharedSampler, &exactSampler}) {
+        sampler->addClip(AnimationClip::createCatIdle());
+        sampler->addClip(AnimationClip::createCatWalk());
+    }
+    std::vector<AnimationSampler::Instance> herd(HERD_SIZE);
+    std::vector<float> herdPhases(HERD_SIZE);
+    uint32_t seed = 12345u;
+    for (size_t i = 0; i < HERD_SIZE; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        herd[i].clip = static_cast<unsigned int>(i % 2);
+        herdPhases[i] = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) * 2.0f;
+    }
+    float herdTime = 0.0f;
+    auto evaluateHerd = [&](AnimationSampler& sampler) {
+        herdTime += 1.0f / 60.0f;
+        for (size_t i = 0; i < HERD_SIZE; i++) {
+            herd[i].time = herdTime + herdPhases[i];
+        }
+        sampler.evaluate(herd.data(), herd.size());
+        return BenchOutput{HERD_SIZE, 0, 0};
+    };
+    results.push_back(runBench("AnimationSampler 10k (shared)", [&]() {
+        return evaluateHerd(sharedSampler);
+    }));
+    results.push_back(runBench("AnimationSampler 10k (exact)", [&]() {
+        return evaluateHerd(exactSampler);
+    }));
+
+    printResults(results);
+    if (!jsonPath.empty() && !writeJson(jsonPath, results)) {
+        return 1;
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,105 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 部件层级：每个部件的父部件（父部件在前，根为-1）和模型空间的旋转中心
+struct Skeleton {
+    std::vector<int> parents;
+    std::vector<glm::vec3> pivots;
+
+    size_t partCount() const { return parents.size(); }
+
+    // 与BuiltinModels::CatPart对应
+    static Skeleton createCat();
+};
+
+// 关键帧动画片段
+// 每个通道（某个部件的旋转或平移）一条曲线，关键帧时间和各分量分别连续存放（SoA），
+// 采样时同一条曲线对一批时间逐分量插值。旋转用四元数(x, y, z, w)，插值为nlerp。
+// 循环片段的最后一帧应与第一帧相同。
+class AnimationClip {
+public:
+    enum class Target {
+        Rotation,
+        Translation
+    };
+
+    struct Curve {
+        unsigned int part;
+        Target target;
+        std::vector<float> times;
+        std::vector<float> x, y, z, w;    // 平移不使用w
+    };
+
+    std::string name;
+    float duration = 0.0f;
+    std::vector<Curve> curves;
+
+    // 关键帧按时间顺序添加，旋转为绕axis转angle弧度
+    void addRotationKey(unsigned int part, float time, float angle, const glm::vec3& axis);
+    void addTranslationKey(unsigned int part, float time, const glm::vec3& translation);
+
+    // 猫的待机（摇尾巴、点头）和行走（对角步态）循环
+    static AnimationClip createCatIdle();
+    static AnimationClip createCatWalk();
+
+private:
+    Curve& curveFor(unsigned int part, Target target);
+};
+
+// 批量动画采样
+// 一次求出所有实例的部件矩阵（可直接交给PartTransforms）。实例时间按sampleRate量化，
+// 同一片段、同一量化时间的实例共用一份姿态，只有不同的姿态才会被采样；
+// 各姿态按批分给JobSystem的线程，曲线插值在每批内按分量成组计算。
+// sampleRate<=0时不量化，每个实例单独采样。
+class AnimationSampler {
+public:
+    struct Instance {
+        unsigned int clip;
+        float time;    // 秒，循环片段按时长取模
+    };
+
+    // 每批同时采样的姿态数
+    static const size_t BATCH = 64;
+
+    explicit AnimationSampler(const Skeleton& skeleton, float sampleRate = 60.0f);
+
+    size_t addClip(const AnimationClip& clip);
+    size_t getClipCount() const { return clips.size(); }
+
+    void evaluate(const Instance* instances, size_t count);
+
+    // 本次求出的不同姿态数和各实例使用的姿态
+    size_t getPoseCount() const { return poseClips.size(); }
+    uint32_t getPoseIndex(size_t instance) const { return instancePoses[instance]; }
+    // 姿态的部件矩阵（skeleton.partCount()个，模型空间）
+    const glm::mat4* getPose(size_t pose) const { return &poses[pose * skeleton.partCount()]; }
+    const glm::mat4* getInstancePose(size_t instance) const { return getPose(instancePoses[instance]); }
+
+private:
+    void sampleBatch(const uint32_t* batch, size_t lanes);
+
+    Skeleton skeleton;
+    float sampleRate;
+    std::vector<AnimationClip> clips;
+    std::vector<uint32_t> clipFrames;      // 每个片段量化后的帧数
+    std::vector<uint32_t> clipFirstSlot;   // 片段在slots中的起始位置
+
+    std::vector<int32_t> slots;            // 片段帧 -> 姿态索引，-1为本次未使用
+    std::vector<uint32_t> instancePoses;
+    std::vector<uint32_t> poseClips;
+    std::vector<float> poseTimes;
+    std::vector<uint32_t> poseOrder;       // 按片段分组的姿态索引
+    std::vector<uint32_t> clipStart;
+    std::vector<uint32_t> clipCursor;
+    std::vector<std::pair<uint32_t, uint32_t>> batches;    // poseOrder中的起点和姿态数
+    std::vector<glm::mat4> poses;
+};
+
+#endif
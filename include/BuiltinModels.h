@@ -0,0 +1,274 @@
+#ifndef BUILTIN_MODELS_H
+#define BUILTIN_MODELS_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "ModelBuilder.h"
+
+// 内置模型的编译期数据
+// 方块列表是constexpr表，原点处、单位尺寸的顶点数组在编译期由同一张表烘焙出来，
+// 启动时直接上传静态数组，不需要任何CPU端的网格生成。
+namespace BuiltinModels {
+
+// 方块定义：相对模型原点的中心偏移和尺寸（按scale缩放），调色板索引和所属部件
+struct BoxDef {
+    float offset[3];
+    float size[3];
+    int color;
+    int part;
+};
+
+// 与Vertex布局相同的纯数据顶点，用于编译期计算
+struct BakedVertex {
+    float position[3];
+    float normal[3];
+    unsigned char color;
+    unsigned char part;
+    unsigned char material;
+    unsigned char padding;
+};
+
+// 猫的调色板索引
+enum CatColor {
+    CatMain,        // 主体灰色
+    CatAccent,      // 强调色
+    CatEyeWhite,    // 眼睛白色部分
+    CatEyeBlack,    // 眼睛黑色部分
+    CatInnerEar,    // 耳朵内部（粉嫩的肉色）
+    CatNose,        // 鼻子颜色（可爱的粉色）
+    CatPaw,         // 爪子颜色（柔和的米色）
+    CatColorCount
+};
+
+// 毛色：同一个网格换调色板即可，顶点缓冲不变
+enum CatCoat {
+    CatCoatGray,
+    CatCoatCalico,    // 橘白花猫
+    CatCoatBlack,
+    CatCoatCount
+};
+
+constexpr float CAT_COATS[CatCoatCount][CatColorCount][3] = {
+    {
+        {0.6f, 0.6f, 0.6f},
+        {0.7f, 0.7f, 0.7f},
+        {1.0f, 1.0f, 1.0f},
+        {0.0f, 0.0f, 0.0f},
+        {1.0f, 0.85f, 0.85f},
+        {1.0f, 0.6f, 0.7f},
+        {0.85f, 0.75f, 0.7f}
+    },
+    {
+        {0.9f, 0.55f, 0.25f},
+        {0.95f, 0.93f, 0.88f},
+        {1.0f, 1.0f, 1.0f},
+        {0.0f, 0.0f, 0.0f},
+        {1.0f, 0.8f, 0.75f},
+        {1.0f, 0.6f, 0.6f},
+        {0.95f, 0.9f, 0.85f}
+    },
+    {
+        {0.12f, 0.12f, 0.13f},
+        {0.2f, 0.2f, 0.22f},
+        {0.95f, 0.85f, 0.3f},
+        {0.0f, 0.0f, 0.0f},
+        {0.45f, 0.3f, 0.35f},
+        {0.35f, 0.25f, 0.3f},
+        {0.18f, 0.18f, 0.2f}
+    }
+};
+
+inline std::vector<glm::vec3> catPalette(CatCoat coat) {
+    std::vector<glm::vec3> palette;
+    for (const float (&color)[3] : CAT_COATS[coat]) {
+        palette.push_back(glm::vec3(color[0], color[1], color[2]));
+    }
+    return palette;
+}
+
+// 猫的部件（骨骼），左边为-x，头朝+z
+enum CatPart {
+    CatBody,            // 身体，固定不动
+    CatHead,            // 头部（含眼睛、耳朵和胡须）
+    CatTail,            // 尾巴前半段
+    CatTailTip,         // 尾巴后半段，动画时叠加在CatTail之上
+    CatLegFrontLeft,
+    CatLegFrontRight,
+    CatLegBackLeft,
+    CatLegBackRight,
+    CatPartCount
+};
+
+// 各部件的旋转中心（模型空间，scale=1）
+constexpr float CAT_PART_PIVOTS[CatPartCount][3] = {
+    { 0.0f,  0.5f,   0.0f},
+    { 0.0f,  0.75f,  0.4f},     // 脖子
+    { 0.0f,  0.6f,  -0.5f},     // 尾巴根部
+    { 0.0f,  0.8f,  -0.8f},
+    {-0.2f,  0.35f,  0.3f},     // 髋部/肩部
+    { 0.2f,  0.35f,  0.3f},
+    {-0.2f,  0.35f, -0.3f},
+    { 0.2f,  0.35f, -0.3f}
+};
+
+// 各部件的父部件（-1为根），父部件在前
+constexpr int CAT_PART_PARENTS[CatPartCount] = {
+    -1,
+    CatBody,
+    CatBody,
+    CatTail,
+    CatBody,
+    CatBody,
+    CatBody,
+    CatBody
+};
+
+constexpr BoxDef CAT_BOXES[] = {
+    // 身体主体
+    {{ 0.0f,   0.5f,   0.0f},  {0.45f,  0.4f,   0.9f},  CatMain,     CatBody},
+    // 身体两侧
+    {{-0.2f,   0.5f,   0.0f},  {0.35f,  0.35f,  0.85f}, CatMain,     CatBody},
+    {{ 0.2f,   0.5f,   0.0f},  {0.35f,  0.35f,  0.85f}, CatMain,     CatBody},
+    // 上部填充
+    {{ 0.0f,   0.65f,  0.0f},  {0.4f,   0.2f,   0.85f}, CatMain,     CatBody},
+    // 下部填充
+    {{ 0.0f,   0.3f,   0.0f},  {0.42f,  0.2f,   0.85f}, CatMain,     CatBody},
+    // 前后填充
+    {{ 0.0f,   0.5f,   0.4f},  {0.43f,  0.38f,  0.2f},  CatMain,     CatBody},
+    {{ 0.0f,   0.5f,  -0.4f},  {0.43f,  0.38f,  0.2f},  CatMain,     CatBody},
+    // 角落填充
+    {{-0.2f,   0.5f,  -0.35f}, {0.25f,  0.35f,  0.25f}, CatMain,     CatBody},
+    {{-0.2f,   0.5f,   0.35f}, {0.25f,  0.35f,  0.25f}, CatMain,     CatBody},
+    {{ 0.2f,   0.5f,  -0.35f}, {0.25f,  0.35f,  0.25f}, CatMain,     CatBody},
+    {{ 0.2f,   0.5f,   0.35f}, {0.25f,  0.35f,  0.25f}, CatMain,     CatBody},
+    // 腹部
+    {{ 0.0f,   0.4f,   0.0f},  {0.4f,   0.3f,   0.8f},  CatAccent,   CatBody},
+    // 腹部填充
+    {{ 0.0f,   0.35f,  0.0f},  {0.38f,  0.25f,  0.75f}, CatAccent,   CatBody},
+    // 腹部边缘填充
+    {{-0.15f,  0.38f,  0.0f},  {0.2f,   0.28f,  0.7f},  CatAccent,   CatBody},
+    {{ 0.15f,  0.38f,  0.0f},  {0.2f,   0.28f,  0.7f},  CatAccent,   CatBody},
+    // 身体与腿部的连接
+    {{-0.2f,   0.3f,  -0.2f},  {0.25f,  0.2f,   0.25f}, CatMain,     CatBody},
+    {{-0.2f,   0.3f,   0.2f},  {0.25f,  0.2f,   0.25f}, CatMain,     CatBody},
+    {{ 0.2f,   0.3f,  -0.2f},  {0.25f,  0.2f,   0.25f}, CatMain,     CatBody},
+    {{ 0.2f,   0.3f,   0.2f},  {0.25f,  0.2f,   0.25f}, CatMain,     CatBody},
+    // 头部
+    {{ 0.0f,   0.8f,   0.5f},  {0.4f,   0.35f,  0.4f},  CatMain,     CatHead},
+    // 面部前突
+    {{ 0.0f,   0.8f,   0.7f},  {0.35f,  0.3f,   0.25f}, CatMain,     CatHead},
+    // 面部轮廓
+    {{ 0.0f,   0.85f,  0.8f},  {0.3f,   0.25f,  0.15f}, CatMain,     CatHead},
+    // 鼻子
+    {{ 0.0f,   0.82f,  0.88f}, {0.12f,  0.12f,  0.08f}, CatNose,     CatHead},
+    // 眼睛白色底色
+    {{-0.15f,  0.9f,   0.75f}, {0.12f,  0.15f,  0.12f}, CatEyeWhite, CatHead},
+    {{ 0.15f,  0.9f,   0.75f}, {0.12f,  0.15f,  0.12f}, CatEyeWhite, CatHead},
+    // 眼睛黑色瞳孔
+    {{-0.15f,  0.9f,   0.77f}, {0.09f,  0.12f,  0.08f}, CatEyeBlack, CatHead},
+    {{ 0.15f,  0.9f,   0.77f}, {0.09f,  0.12f,  0.08f}, CatEyeBlack, CatHead},
+    // 主高光
+    {{-0.17f,  0.93f,  0.79f}, {0.04f,  0.04f,  0.04f}, CatEyeWhite, CatHead},
+    {{ 0.13f,  0.93f,  0.79f}, {0.04f,  0.04f,  0.04f}, CatEyeWhite, CatHead},
+    // 次高光
+    {{-0.13f,  0.9f,   0.79f}, {0.03f,  0.03f,  0.04f}, CatEyeWhite, CatHead},
+    {{ 0.17f,  0.9f,   0.79f}, {0.03f,  0.03f,  0.04f}, CatEyeWhite, CatHead},
+    // 小高光
+    {{-0.15f,  0.87f,  0.79f}, {0.02f,  0.02f,  0.04f}, CatEyeWhite, CatHead},
+    {{ 0.15f,  0.87f,  0.79f}, {0.02f,  0.02f,  0.04f}, CatEyeWhite, CatHead},
+    // 左耳
+    {{-0.18f,  1.1f,   0.5f},  {0.15f,  0.3f,   0.15f}, CatMain,     CatHead},
+    {{-0.18f,  1.1f,   0.52f}, {0.1f,   0.25f,  0.1f},  CatInnerEar, CatHead},
+    // 右耳
+    {{ 0.18f,  1.1f,   0.5f},  {0.15f,  0.3f,   0.15f}, CatMain,     CatHead},
+    {{ 0.18f,  1.1f,   0.52f}, {0.1f,   0.25f,  0.1f},  CatInnerEar, CatHead},
+    // 胡须基座
+    {{-0.2f,   0.82f,  0.85f}, {0.08f,  0.08f,  0.08f}, CatMain,     CatHead},
+    {{ 0.2f,   0.82f,  0.85f}, {0.08f,  0.08f,  0.08f}, CatMain,     CatHead},
+    // 左边胡须
+    {{-0.35f,  0.85f,  0.85f}, {0.25f,  0.02f,  0.02f}, CatEyeWhite, CatHead},
+    {{-0.35f,  0.82f,  0.85f}, {0.25f,  0.02f,  0.02f}, CatEyeWhite, CatHead},
+    {{-0.35f,  0.79f,  0.85f}, {0.25f,  0.02f,  0.02f}, CatEyeWhite, CatHead},
+    // 右边胡须
+    {{ 0.35f,  0.85f,  0.85f}, {0.25f,  0.02f,  0.02f}, CatEyeWhite, CatHead},
+    {{ 0.35f,  0.82f,  0.85f}, {0.25f,  0.02f,  0.02f}, CatEyeWhite, CatHead},
+    {{ 0.35f,  0.79f,  0.85f}, {0.25f,  0.02f,  0.02f}, CatEyeWhite, CatHead},
+    // 前腿
+    {{-0.2f,   0.2f,   0.3f},  {0.15f,  0.3f,   0.15f}, CatMain,     CatLegFrontLeft},
+    {{ 0.2f,   0.2f,   0.3f},  {0.15f,  0.3f,   0.15f}, CatMain,     CatLegFrontRight},
+    // 后腿
+    {{-0.2f,   0.2f,  -0.3f},  {0.15f,  0.3f,   0.15f}, CatMain,     CatLegBackLeft},
+    {{ 0.2f,   0.2f,  -0.3f},  {0.15f,  0.3f,   0.15f}, CatMain,     CatLegBackRight},
+    // 前爪
+    {{-0.2f,   0.05f,  0.3f},  {0.12f,  0.1f,   0.12f}, CatPaw,      CatLegFrontLeft},
+    {{ 0.2f,   0.05f,  0.3f},  {0.12f,  0.1f,   0.12f}, CatPaw,      CatLegFrontRight},
+    // 后爪
+    {{-0.2f,   0.05f, -0.3f},  {0.12f,  0.1f,   0.12f}, CatPaw,      CatLegBackLeft},
+    {{ 0.2f,   0.05f, -0.3f},  {0.12f,  0.1f,   0.12f}, CatPaw,      CatLegBackRight},
+    // 尾巴根部
+    {{ 0.0f,   0.6f,  -0.6f},  {0.12f,  0.12f,  0.25f}, CatMain,     CatTail},
+    // 尾巴中部（向上弯曲）
+    {{ 0.0f,   0.7f,  -0.75f}, {0.1f,   0.1f,   0.2f},  CatMain,     CatTail},
+    // 尾巴第三段（继续向上弯曲）
+    {{ 0.0f,   0.85f, -0.85f}, {0.09f,  0.09f,  0.18f}, CatMain,     CatTailTip},
+    // 尾巴第四段（更细）
+    {{ 0.0f,   0.95f, -0.9f},  {0.08f,  0.08f,  0.15f}, CatMain,     CatTailTip},
+    // 尾巴尖端（最细）
+    {{ 0.0f,   1.0f,  -0.95f}, {0.06f,  0.06f,  0.1f},  CatMain,     CatTailTip},
+    // 尾巴连接处的平滑过渡
+    {{ 0.0f,   0.65f, -0.67f}, {0.11f,  0.11f,  0.15f}, CatMain,     CatTail},
+    {{ 0.0f,   0.77f, -0.8f},  {0.095f, 0.095f, 0.15f}, CatMain,     CatTail},
+    {{ 0.0f,   0.9f,  -0.87f}, {0.085f, 0.085f, 0.12f}, CatMain,     CatTailTip}
+};
+
+constexpr size_t CAT_BOX_COUNT = sizeof(CAT_BOXES) / sizeof(CAT_BOXES[0]);
+
+// 编译期生成顶点，计算方式与ModelBuilder::writeFace完全相同（位置为原点、尺寸为1时结果逐位一致）
+template <size_t N>
+constexpr std::array<BakedVertex, N * ModelBuilder::VERTICES_PER_BOX> bake(const BoxDef (&boxes)[N]) {
+    std::array<BakedVertex, N * ModelBuilder::VERTICES_PER_BOX> result{};
+    size_t index = 0;
+    for (size_t b = 0; b < N; b++) {
+        const BoxDef& box = boxes[b];
+        for (size_t i = 0; i < ModelBuilder::VERTICES_PER_BOX; i++) {
+            BakedVertex& vertex = result[index++];
+            for (int axis = 0; axis < 3; axis++) {
+                vertex.position[axis] = ModelBuilder::cornerOffset(box.offset[axis], ModelBuilder::CUBE_CORNERS[i][axis],
+                                                                   box.size[axis] / 2.0f);
+                vertex.normal[axis] = ModelBuilder::CUBE_NORMALS[i / ModelBuilder::VERTICES_PER_FACE][axis];
+            }
+            vertex.color = static_cast<unsigned char>(box.color);
+            vertex.part = static_cast<unsigned char>(box.part);
+            vertex.material = 0;
+            vertex.padding = 0;
+        }
+    }
+    return result;
+}
+
+// 包围盒：{min, max}
+template <size_t N>
+constexpr std::array<std::array<float, 3>, 2> bakeBounds(const std::array<BakedVertex, N>& vertices) {
+    std::array<std::array<float, 3>, 2> bounds{};
+    for (int axis = 0; axis < 3; axis++) {
+        bounds[0][axis] = vertices[0].position[axis];
+        bounds[1][axis] = vertices[0].position[axis];
+    }
+    for (size_t i = 0; i < N; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            float value = vertices[i].position[axis];
+            bounds[0][axis] = value < bounds[0][axis] ? value : bounds[0][axis];
+            bounds[1][axis] = value > bounds[1][axis] ? value : bounds[1][axis];
+        }
+    }
+    return bounds;
+}
+
+inline constexpr std::array<BakedVertex, CAT_BOX_COUNT * ModelBuilder::VERTICES_PER_BOX> CAT_VERTICES =
+    bake(CAT_BOXES);
+inline constexpr std::array<std::array<float, 3>, 2> CAT_BOUNDS = bakeBounds(CAT_VERTICES);
+
+}
+
+#endif
@@ -35,9 +35,14 @@ public:
     void ZoomIn(float deltaTime);        // +键
     void ZoomOut(float deltaTime);       // -键
 
+    // 自上次调用以来相机位置是否改变（按需渲染用），调用后清除标记
+    bool ConsumeChanged();
+
 private:
     // 更新相机位置
     void updateCameraPosition();
+
+    bool changed;
 };
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <GL/glew.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// GL诊断
+// 运行时分三级：
+//   Off   不开启调试输出，不检查glGetError（创建窗口时也不请求调试上下文）
+//   Async 异步调试输出：驱动线程在回调中只把消息写入无锁环形缓冲，主线程每帧在endFrame中取出，
+//         按(来源, 类型, id)去重，同一消息只打印第一次，其余计数，退出时汇总
+//   Sync  同步调试输出，回调中直接打印；每帧以及每次绘制后读取glGetError（用于定位出错的调用）
+// 逐次绘制的检查（GL_CHECK）和绘制路径上的警告（DIAGNOSTIC_WARNING）只在未定义NDEBUG时编译，
+// 发布版本中展开为空，绘制没有任何诊断开销。
+class Diagnostics {
+public:
+    enum class Level {
+        Off,
+        Async,
+        Sync
+    };
+
+    static const size_t RING_SIZE = 256;          // 2的幂
+    static const size_t MESSAGE_LENGTH = 256;     // 每条消息保留的字符数（含结尾的0）
+
+    static Diagnostics& get();
+
+    // 名称为off、async或sync，无法识别时返回false
+    static bool parseLevel(const std::string& name, Level& level);
+    static const char* levelName(Level level);
+    // 未定义NDEBUG时默认Async，否则Off
+    static Level defaultLevel();
+
+    // 设置级别并配置当前上下文的调试输出；Async/Sync需要调试上下文（GLFW_OPENGL_DEBUG_CONTEXT）
+    void setLevel(Level level);
+    Level getLevel() const { return level; }
+
+    // 每帧调用一次：Async取出环形缓冲中的消息，Sync读取glGetError
+    void endFrame();
+    // Sync级别时读取并打印glGetError，label为出错位置
+    void checkErrors(const char* label);
+    // 绘制路径上的警告，按消息指针（字符串常量）去重，只打印第一次
+    void warning(const char* message);
+
+    // 收到的消息总数、不同消息的数量和环形缓冲满时丢弃的数量
+    uint64_t getMessageCount() const { return messageCount; }
+    size_t getUniqueCount() const { return messages.size() + warnings.size(); }
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+    void printSummary() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        GLenum source;
+        GLenum type;
+        GLuint id;
+        GLenum severity;
+        char text[MESSAGE_LENGTH];
+    };
+
+    struct Message {
+        GLenum type;
+        GLenum severity;
+        uint64_t count;
+        std::string text;
+    };
+
+    Diagnostics();
+    Diagnostics(const Diagnostics&) = delete;
+    Diagnostics& operator=(const Diagnostics&) = delete;
+
+    static void GLAPIENTRY asyncCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                         GLsizei length, const GLchar* message, const void* userParam);
+    static void GLAPIENTRY syncCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                        GLsizei length, const GLchar* message, const void* userParam);
+    static void print(GLenum source, GLenum type, GLuint id, GLenum severity, const char* message);
+
+    // 多个线程都可能写入（驱动线程、主线程），只有主线程读取
+    void push(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message);
+    void drain();
+
+    Level level;
+    Slot ring[RING_SIZE];
+    std::atomic<uint64_t> writePosition;
+    uint64_t readPosition;
+    std::atomic<uint64_t> dropped;
+    uint64_t messageCount;
+    std::unordered_map<uint64_t, Message> messages;          // 键为(来源, 类型, id)
+    std::unordered_map<const char*, uint64_t> warnings;
+};
+
+#ifndef NDEBUG
+#define GL_CHECK(label) \
+    do { \
+        if (Diagnostics::get().getLevel() == Diagnostics::Level::Sync) Diagnostics::get().checkErrors(label); \
+    } while (0)
+#define DIAGNOSTIC_WARNING(message) Diagnostics::get().warning(message)
+#else
+#define GL_CHECK(label) ((void)0)
+#define DIAGNOSTIC_WARNING(message) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <cstddef>
+#include <vector>
+
+// 动态分辨率
+// 根据GpuProfiler测得的GPU耗时调整场景的内部渲染分辨率：场景按窗口尺寸除以整数divisor渲染，
+// divisor只取像素块大小的约数（像素块为4时为1、2、4），每个像素块对应整数个场景像素，放大后依然清晰。
+// 场景耗时按面积缩放、后处理等其他耗时不变，据此预测切换后的帧耗时：
+//   平滑后的帧耗时超过预算时提高divisor；预测降低divisor后仍低于预算的UPSCALE_HEADROOM时才降低，
+//   两个阈值之间留出滞回区间，启动和切换后先等待SETTLE_FRAMES帧（跳过着色器编译、覆盖计时查询的延迟）才重新判断，避免来回振荡。
+class DynamicResolution {
+public:
+    static const int SETTLE_FRAMES = 16;
+    static constexpr double UPSCALE_HEADROOM = 0.8;
+    static constexpr double SMOOTHING = 0.2;    // 指数平滑的系数
+
+    // maxDivisor为像素块大小，budgetMs为目标帧耗时
+    DynamicResolution(int maxDivisor, double budgetMs);
+
+    // 每帧调用：sceneMs为随分辨率缩放的阶段耗时，fixedMs为其余阶段耗时；负数表示还没有计时结果
+    // divisor改变时返回true
+    bool update(double sceneMs, double fixedMs);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+    void setBudgetMs(double ms) { budgetMs = ms; }
+    double getBudgetMs() const { return budgetMs; }
+
+    int getDivisor() const { return divisors[level]; }
+    // 窗口尺寸对应的场景渲染尺寸（向上取整）
+    int scale(int size) const { return (size + getDivisor() - 1) / getDivisor(); }
+    // 最近的平滑帧耗时（毫秒）
+    double getSmoothedMs() const { return smoothedScene + smoothedFixed; }
+    unsigned int getChanges() const { return changes; }
+
+private:
+    void setLevel(size_t newLevel);
+
+    std::vector<int> divisors;    // 从小到大
+    size_t level;
+    double budgetMs;
+    double smoothedScene;
+    double smoothedFixed;
+    int settle;
+    bool hasSample;
+    bool enabled;
+    unsigned int changes;
+};
+
+#endif
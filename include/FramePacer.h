@@ -0,0 +1,78 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 帧节奏与输入延迟
+// 交换间隔：VSync（glfwSwapInterval(1)）、Adaptive（-1，错过垂直同步时立即交换，驱动不支持时退回VSync）、
+// Uncapped（0）。帧率限制器按固定周期推进截止时间，先睡眠到截止时间前SPIN_NS，再自旋到截止时间，
+// 避免只用sleep时受系统计时器精度影响而抖动。
+// 每帧记录从采样输入（markInput）到交换完成（markSwap）的时间，作为输入到显示延迟的近似值，
+// 同时写入CPU trace（inputToSwap区间）。
+class FramePacer {
+public:
+    enum class SwapMode {
+        VSync,
+        Adaptive,
+        Uncapped,
+        Count
+    };
+
+    static const int64_t SPIN_NS = 2000000;     // 截止时间前自旋的时长（2ms）
+    static const size_t MAX_HISTORY = 10000;    // 保留的延迟样本数
+
+    struct LatencyStats {
+        size_t samples;
+        double minMs;
+        double avgMs;
+        double p99Ms;
+        double maxMs;
+    };
+
+    FramePacer();
+
+    // 设置交换间隔，需要当前的GL上下文
+    void setSwapMode(SwapMode mode);
+    SwapMode getSwapMode() const { return swapMode; }
+    static const char* swapModeName(SwapMode mode);
+    // 名称为vsync、adaptive或uncapped，无法识别时返回false
+    static bool parseSwapMode(const std::string& name, SwapMode& mode);
+
+    // 目标帧率，0为不限制
+    void setTargetFps(double fps);
+    double getTargetFps() const { return targetFps; }
+
+    // 每帧开始（采样输入之前）调用：等待到下一帧的截止时间
+    void waitForNextFrame();
+    // 暂停出帧（如按需渲染空闲）之后调用，下一帧重新开始计时，不计入错过的帧
+    void reset();
+    // 采样输入（处理事件、读取按键）时调用
+    void markInput();
+    // glfwSwapBuffers返回后调用
+    void markSwap();
+
+    // 最近一帧的输入延迟（毫秒），还没有样本时返回负数
+    double getLastLatencyMs() const { return lastLatencyMs; }
+    LatencyStats getLatencyStats() const;
+    // 已经落后超过一个周期、重新对齐截止时间的次数
+    uint64_t getMissedFrames() const { return missedFrames; }
+    void printSummary() const;
+
+    static int64_t now();
+
+private:
+    SwapMode swapMode;
+    double targetFps;
+    int64_t periodNs;
+    int64_t deadlineNs;
+    int64_t inputNs;
+    double lastLatencyMs;
+    std::vector<double> latencies;     // 环形存储的延迟（毫秒）
+    size_t nextLatency;
+    uint64_t missedFrames;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define FRAMEBUFFER_H
 
 #include <GL/glew.h>
+#include "MemoryTracker.h"
 
 class Framebuffer {
 public:
@@ -9,16 +10,29 @@ public:
     unsigned int texture;
     unsigned int RBO;
     
-    Framebuffer(int width, int height);
+    // colorFormat为颜色附件的内部格式；depth为false时不创建深度/模板附件（后处理的中间目标）
+    Framebuffer(int width, int height, MemoryCategory category = MemoryCategory::RenderTarget,
+                GLenum colorFormat = GL_RGB, bool depth = true);
     ~Framebuffer();
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
     
     void Bind();
     void Unbind();
+    // 尺寸变化时重新创建所有附件；窗口缩放时应改用RenderTargetPool
     void Resize(int width, int height);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    GLenum getColorFormat() const { return colorFormat; }
+    bool hasDepth() const { return depth; }
     
 private:
     int width;
     int height;
+    MemoryCategory category;    // 附件计入的内存分类
+    GLenum colorFormat;
+    bool depth;
     void Create();
     void Cleanup();
 };
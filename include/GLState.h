@@ -0,0 +1,66 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <GL/glew.h>
+
+// GL状态缓存
+// 记录当前上下文绑定的程序、VAO、缓冲、帧缓冲、视口、深度/混合状态和纹理单元，
+// 与缓存相同的调用直接跳过。引擎中的类都经由它修改这些状态；绕过它直接调用GL后需要invalidate()。
+// 实际发出和跳过的调用数累加到RenderStats。渲染只在主线程进行，使用单一上下文。
+class GLState {
+public:
+    static const unsigned int MAX_TEXTURE_UNITS = 16;
+    static const unsigned int MAX_UNIFORM_BINDINGS = 16;
+
+    static GLState& get();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    // GL_ARRAY_BUFFER和GL_UNIFORM_BUFFER会被缓存，其他目标直接调用
+    void bindBuffer(GLenum target, GLuint buffer);
+    // 绑定uniform缓冲到绑定点（同时改变GL_UNIFORM_BUFFER的通用绑定）
+    void bindUniformBuffer(GLuint binding, GLuint buffer);
+    void bindFramebuffer(GLuint framebuffer);
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    // GL_DEPTH_TEST、GL_BLEND、GL_CULL_FACE会被缓存，其他开关直接调用
+    void setEnabled(GLenum capability, bool enabled);
+    void depthMask(bool enabled);
+    void blendFunc(GLenum source, GLenum destination);
+    // 绑定纹理到指定单元，必要时切换当前纹理单元；只缓存GL_TEXTURE_2D，其他目标直接调用
+    void bindTexture(GLuint unit, GLuint texture, GLenum target = GL_TEXTURE_2D);
+    // 切换当前纹理单元，glTexSubImage2D等针对当前单元的调用之前使用
+    void activeTexture(GLuint unit);
+
+    // 对象删除后调用：GL会把已删除的对象从绑定点上解除，而名字可能被重新分配
+    void deleteVertexArray(GLuint vao);
+    void deleteBuffer(GLuint buffer);
+    void deleteFramebuffer(GLuint framebuffer);
+    void deleteTexture(GLuint texture);
+
+    // 忘记所有缓存的状态，下次调用一定会发出
+    void invalidate();
+
+private:
+    GLState();
+
+    // 缓存命中时返回false并计为跳过，否则计为发出
+    bool change(bool changed);
+
+    GLuint program;
+    GLuint vertexArray;
+    GLuint arrayBuffer;
+    GLuint uniformBuffer;
+    GLuint uniformBindings[MAX_UNIFORM_BINDINGS];
+    GLuint framebuffer;
+    GLint viewportRect[4];
+    int depthTest;
+    int blend;
+    int cullFace;
+    int depthWrite;
+    GLenum blendSource;
+    GLenum blendDestination;
+    GLuint activeUnit;
+    GLuint textures[MAX_TEXTURE_UNITS];
+};
+
+#endif
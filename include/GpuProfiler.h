@@ -0,0 +1,123 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// GPU计时器：用GL_TIME_ELAPSED查询测量每个渲染阶段（阴影、场景、后处理、回读）的耗时。
+// 查询对象放在多帧环形缓冲中，结果延迟FRAME_LATENCY帧后再读取，读取时不会阻塞管线。
+// llvmpipe等软件光栅器把光栅化推迟到提交时执行，计时查询量不到实际工作，
+// 因此在这类驱动上改为用glFinish包围阶段、按CPU时间计时。
+class GpuProfiler {
+public:
+    enum class Mode {
+        TimerQuery,    // 硬件GPU：异步计时查询
+        FinishFence    // 软件光栅器：glFinish + CPU计时
+    };
+
+    static const int FRAME_LATENCY = 4;        // 环形缓冲的帧数
+    static const size_t MAX_HISTORY = 10000;   // 每个阶段保留的样本数（用于统计）
+    static const size_t MAX_TRACE_EVENTS = 200000;
+
+    // 单个阶段的统计结果（毫秒）
+    struct PassStats {
+        std::string name;
+        size_t samples;
+        double minMs;
+        double avgMs;
+        double p99Ms;
+        double lastMs;
+    };
+
+    GpuProfiler();
+    explicit GpuProfiler(Mode mode);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // 每帧调用：开始时回收已完成的查询，结束时推进环形缓冲
+    void beginFrame();
+    void endFrame();
+    // 等待GPU完成并取回所有未读取的查询（退出或导出前调用）
+    void flush();
+
+    // 标记一个渲染阶段，阶段之间不能嵌套
+    void beginPass(const char* name);
+    void endPass();
+
+    std::vector<PassStats> getStats() const;
+    // 最近一次完成的某阶段耗时（毫秒），没有数据时返回负数
+    double getLastMs(const char* name) const;
+    // 某阶段保留的全部样本（毫秒，顺序不保证）
+    std::vector<double> getSamples(const char* name) const;
+    uint64_t getDroppedFrames() const { return droppedFrames; }
+    Mode getMode() const { return mode; }
+
+    // 根据GL_RENDERER选择计时方式
+    static Mode detectMode();
+
+    void printSummary() const;
+    bool exportCsv(const std::string& path) const;
+    bool exportTrace(const std::string& path) const;
+
+private:
+    struct PendingQuery {
+        int pass;
+        unsigned int elapsedQuery;
+        unsigned int beginQuery;       // 阶段开始/结束的GL_TIMESTAMP，用于放置trace事件和校验耗时
+        unsigned int endQuery;
+    };
+
+    struct FrameSlot {
+        uint64_t frameIndex;
+        std::vector<PendingQuery> queries;
+        // 查询对象首次使用时就绑定了类型，两种查询分开回收
+        std::vector<unsigned int> freeElapsed;
+        std::vector<unsigned int> freeTimestamps;
+    };
+
+    struct PassHistory {
+        std::string name;
+        std::vector<double> samples;   // 环形存储的耗时（毫秒）
+        size_t next;
+        size_t total;
+        double lastMs;
+    };
+
+    struct TraceEvent {
+        int pass;
+        uint64_t frameIndex;
+        int64_t startNs;               // CPU steady_clock时间轴，与CPU profiler的trace对齐
+        uint64_t durationNs;
+    };
+
+    Mode mode;
+    FrameSlot slots[FRAME_LATENCY];
+    std::vector<PassHistory> passes;
+    std::vector<TraceEvent> traceEvents;
+    uint64_t frameIndex;
+    uint64_t droppedFrames;
+    int activePass;
+    bool inFrame;
+    int64_t gpuToCpuOffsetNs;           // GPU时间戳换算到CPU时间轴的偏移
+    int64_t passStartNs;                // FinishFence模式下当前阶段的开始时间
+
+    int findOrAddPass(const char* name);
+    unsigned int acquireQuery(std::vector<unsigned int>& freeList);
+    void recycleQueries(FrameSlot& slot);
+    void collect(FrameSlot& slot);
+    void record(int pass, uint64_t frame, int64_t startNs, uint64_t durationNs);
+    void calibrate();
+};
+
+// 作用域辅助类：构造时beginPass，析构时endPass
+struct GpuPassScope {
+    GpuProfiler& profiler;
+    GpuPassScope(GpuProfiler& profiler, const char* name) : profiler(profiler) { profiler.beginPass(name); }
+    ~GpuPassScope() { profiler.endPass(); }
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 任务系统
+// 常驻的工作线程池，用于每帧都要执行的并行工作（避免每次创建线程的开销）。
+// parallelFor把区间按grain大小分块，工作线程和调用线程一起领取，返回时全部完成。
+class JobSystem {
+public:
+    // threads为包括调用线程在内的线程数，0时使用硬件线程数
+    explicit JobSystem(unsigned threads = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // 对[0, count)按块调用task(begin, end)；块数不超过1时直接在调用线程执行
+    // 不可重入：在task中再调用同一个JobSystem的parallelFor会在submitMutex上死锁
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& task);
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // 全局共享的线程池
+    static JobSystem& get();
+
+private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> workers;
+    std::mutex submitMutex;    // 同一时间只执行一个parallelFor
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    const std::function<void(size_t, size_t)>* task;
+    size_t count;
+    size_t grain;
+    std::atomic<size_t> next;
+    unsigned pending;
+    uint64_t generation;
+    bool stopping;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef MATERIAL_TABLE_H
+#define MATERIAL_TABLE_H
+
+#include <cstddef>
+#include <vector>
+#include "Material.h"
+
+// 材质表
+// 所有材质放在一个std140布局的uniform缓冲里，只在材质改动后上传。顶点带材质索引（Vertex::Material），
+// 绘制时只需设置一个整数基址（uniform materialBase），片段着色器按基址+顶点索引取材质参数，
+// 含多种材质的网格也只需一次绘制，绘制之间没有材质uniform的改动。
+class MaterialTable {
+public:
+    // 与fragment.glsl中的MAX_MATERIALS一致
+    static const unsigned int MAX_MATERIALS = 64;
+    // uniform块Materials的绑定点
+    static const unsigned int BINDING = 1;
+
+    MaterialTable();
+    ~MaterialTable();
+    MaterialTable(const MaterialTable&) = delete;
+    MaterialTable& operator=(const MaterialTable&) = delete;
+
+    // 添加材质，返回索引；表满时给出警告并返回0
+    unsigned int add(const Material& material);
+    void set(unsigned int index, const Material& material);
+    const Material& get(unsigned int index) const { return materials[index]; }
+    size_t size() const { return materials.size(); }
+
+    // 有改动时上传，并绑定到BINDING
+    void bind();
+
+private:
+    std::vector<Material> materials;
+    unsigned int UBO;
+    bool dirty;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 内存分类
+enum class MemoryCategory {
+    Mesh,            // 顶点缓冲
+    RenderTarget,    // 帧缓冲的颜色/深度附件
+    Shadow,          // 阴影贴图
+    Capture,         // 截图、回读缓冲
+    CpuMesh,         // CPU端的顶点副本和源方块
+    Uniform,         // uniform缓冲（部件变换等）
+    Palette,         // 调色板纹理
+    Count
+};
+
+// 显存/内存统计
+// 记录每一次glBufferData/glTexImage2D/glTexImage3D/glRenderbufferStorage分配和对应的释放，
+// 按分类和所属对象汇总，提供当前用量、峰值和定期输出的日志行。
+// 同一个资源重新分配时替换原有记录，因此重复上传不会重复计数。
+class MemoryTracker {
+public:
+    // 资源种类，与GL对象名一起唯一标识一项分配（CPU资源用所属对象的地址作为名字）
+    enum class Resource {
+        Buffer,
+        Texture,
+        Renderbuffer,
+        Cpu
+    };
+
+    struct CategoryStats {
+        size_t liveBytes = 0;
+        size_t peakBytes = 0;
+        size_t liveAllocations = 0;
+        uint64_t totalAllocations = 0;
+    };
+
+    struct OwnerUsage {
+        const void* owner;
+        std::string label;
+        size_t bytes;
+    };
+
+    static MemoryTracker& get();
+
+    // 记录一项分配（已存在则替换），owner/label用于按对象汇总
+    void record(Resource resource, uint64_t name, MemoryCategory category,
+                const void* owner, const char* label, size_t bytes);
+    void release(Resource resource, uint64_t name);
+    // 对象移动后更新所属者
+    void transfer(Resource resource, uint64_t name, const void* newOwner);
+
+    // 带统计的GL分配函数，调用前需绑定好对应的对象
+    void bufferData(GLenum target, GLuint buffer, size_t size, const void* data, GLenum usage,
+                    MemoryCategory category, const void* owner, const char* label);
+    void texImage2D(GLuint texture, GLint internalFormat, int width, int height, GLenum format,
+                    GLenum type, const void* pixels, MemoryCategory category,
+                    const void* owner, const char* label);
+    // 3D纹理（如调色板量化的查找表），绑定到GL_TEXTURE_3D
+    void texImage3D(GLuint texture, GLint internalFormat, int width, int height, int depth, GLenum format,
+                    GLenum type, const void* pixels, MemoryCategory category,
+                    const void* owner, const char* label);
+    void renderbufferStorage(GLuint renderbuffer, GLenum internalFormat, int width, int height,
+                             MemoryCategory category, const void* owner, const char* label);
+
+    CategoryStats getStats(MemoryCategory category) const;
+    size_t getLiveBytes() const;
+    size_t getPeakBytes() const;
+    // 按所属对象汇总的当前用量，从大到小排列
+    std::vector<OwnerUsage> getOwners() const;
+
+    // 每隔interval秒输出一次日志行，interval<=0时关闭
+    void setLogInterval(double seconds) { logInterval = seconds; }
+    void update(double nowSeconds);
+    std::string logLine() const;
+    void printSummary(size_t topOwners = 10) const;
+
+    static const char* categoryName(MemoryCategory category);
+    // 按内部格式估算每个像素的字节数（驱动通常把RGB8补齐为4字节）
+    static size_t bytesPerPixel(GLenum internalFormat);
+
+private:
+    struct Allocation {
+        MemoryCategory category;
+        const void* owner;
+        std::string label;
+        size_t bytes;
+    };
+
+    using Key = std::pair<int, uint64_t>;
+
+    mutable std::mutex mutex;
+    std::map<Key, Allocation> allocations;
+    CategoryStats categories[static_cast<int>(MemoryCategory::Count)];
+    size_t liveBytes = 0;
+    size_t peakBytes = 0;
+    double logInterval = 0.0;
+    double lastLogTime = -1.0;
+
+    MemoryTracker() = default;
+    void releaseLocked(const Key& key);
+};
+
+#endif
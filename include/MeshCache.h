@@ -0,0 +1,74 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Model.h"
+
+// 网格缓存
+// 生成好的顶点以GPU可直接使用的布局存成二进制文件，文件名由源数据和网格生成器版本的哈希决定。
+// 加载时把文件映射到内存，映射区直接交给glBufferData，没有解析和逐顶点拷贝。
+//
+// 文件布局（小端序）：
+//   Header（72字节）
+//   顶点数据：从vertexOffset开始，vertexCount个Vertex，按BLOB_ALIGNMENT对齐
+//   索引数据：从indexOffset开始，indexCount个uint32（目前的网格都不使用索引，为0）
+class MeshCache {
+public:
+    static const uint32_t MAGIC = 0x4d334150;        // "PA3M"
+    static const uint32_t FORMAT_VERSION = 4;
+    // 修改ModelBuilder或VoxMesher的输出时递增，旧缓存随之失效
+    static const uint32_t MESHER_VERSION = 2;
+    static const size_t BLOB_ALIGNMENT = 64;
+    static const size_t SAMPLE_COUNT = 64;
+    static const size_t SAMPLE_BYTES = 256;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t formatVersion;
+        uint32_t mesherVersion;
+        uint32_t vertexStride;
+        uint64_t key;
+        uint64_t vertexCount;
+        uint64_t vertexOffset;
+        uint32_t indexCount;
+        uint32_t indexOffset;
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+
+    explicit MeshCache(const std::string& directory);
+
+    // 命中时把缓存的网格上传到model（不保留CPU副本）
+    bool load(uint64_t key, Model& model) const;
+    // 写入缓存（先写临时文件再改名，不会留下半个文件）
+    bool store(uint64_t key, const Vertex* vertices, size_t count,
+               const glm::vec3& boundsMin, const glm::vec3& boundsMax) const;
+
+    std::string pathFor(uint64_t key) const;
+    // path旁边的临时文件名，包含进程号和计数，多个进程同时写同一个文件时各自写入自己的临时文件
+    static std::string temporaryPath(const std::string& path);
+    const std::string& getDirectory() const { return directory; }
+
+    // 64位FNV-1a，seed用于串联多段数据
+    static uint64_t hash(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+    // 每次处理8字节的哈希，用于大块数据（逐字节的FNV-1a太慢）
+    static uint64_t hashWords(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+    // 只哈希等间距的SAMPLE_COUNT段、每段SAMPLE_BYTES字节（数据不大时全部哈希），与大小、修改时间一起作为文件的键
+    static uint64_t hashSampled(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+    // 方块列表的缓存键（包含网格生成器版本和顶点布局）
+    static uint64_t keyFor(const Box* boxes, size_t count);
+
+    // 工厂函数和加载器使用的缓存，为空时不使用缓存
+    static MeshCache* getDefault() { return defaultCache; }
+    static void setDefault(MeshCache* cache) { defaultCache = cache; }
+
+private:
+    std::string directory;
+
+    static MeshCache* defaultCache;
+};
+
+#endif
@@ -2,24 +2,96 @@
 #define MODEL_H
 
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <vector>
 
+// 顶点：颜色、部件和材质都是单字节索引
 struct Vertex {
     glm::vec3 Position;
-    glm::vec3 Color;
     glm::vec3 Normal;
+    uint8_t Color;       // 调色板索引，顶点着色器从调色板纹理取颜色
+    uint8_t Part;        // 部件（骨骼）索引，顶点着色器按它选取部件变换
+    uint8_t Material;    // 材质索引（相对绘制时的材质基址），片段着色器按它查MaterialTable
+    uint8_t Padding;
+};
+
+// 方块描述：中心位置、尺寸、调色板索引、所属部件和材质
+struct Box {
+    glm::vec3 position;
+    glm::vec3 size;
+    unsigned int color;
+    unsigned int part = 0;
+    unsigned int material = 0;
 };
 
 class Model {
 public:
+    // 顶点数据的驻留方式
+    enum class Residency {
+        CpuAndGpu,    // 上传后保留CPU顶点副本
+        GpuOnly       // 只保留GPU缓冲、顶点数和包围盒，CPU副本在需要时由源数据重建
+    };
+
     std::vector<Vertex> vertices;
+    // 调色板（最多MAX_PALETTE_COLORS色），顶点的Color是其中的索引；由Scene上传到PaletteAtlas
+    std::vector<glm::vec3> palette;
     unsigned int VAO, VBO;
 
+    // 上传后的网格信息，不依赖CPU顶点副本
+    size_t vertexCount;
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+    Residency residency;
+
+    // 工厂函数创建模型时使用的驻留方式
+    static Residency defaultResidency;
+
+    static const size_t MAX_PALETTE_COLORS = 256;
+    // 颜色在调色板中的索引，没有时追加；调色板已满时给出警告并返回0
+    static unsigned int paletteIndex(std::vector<glm::vec3>& palette, const glm::vec3& color);
+
     Model();
     ~Model();
 
+    // 模型持有GL对象，只能移动不能拷贝
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+    Model(Model&& other) noexcept;
+    Model& operator=(Model&& other) noexcept;
+
     void setupMesh();
     void draw() const;
+    // 分开绑定和绘制，供连续绘制同一网格时省去重复的VAO切换（如RenderQueue）
+    bool bindMesh() const;
+    void drawBound() const;
+
+    // 直接上传外部顶点数据（如映射的缓存文件），包围盒由调用方给出，不改动CPU副本
+    void uploadMesh(const Vertex* data, size_t count, const glm::vec3& meshMin, const glm::vec3& meshMax);
+
+    // 分配size个顶点的GPU缓冲并映射以便直接写入，写完后调用unmapMesh
+    Vertex* mapMesh(size_t count);
+    bool unmapMesh();
+
+    // 不由方块描述的模型（如.vox）用来重建顶点的函数，写出的顶点替换out
+    using SourceGenerator = std::function<void(std::vector<Vertex>& out)>;
+
+    // 释放CPU顶点副本（保留源数据以便之后重建）
+    void releaseCpuData();
+    // 确保CPU顶点副本存在（编辑或导出前调用），GpuOnly模式下由源数据重新生成；
+    // 已上传却没有源数据时给出警告并返回空数组
+    const std::vector<Vertex>& ensureCpuData();
+    void setSource(const Box* boxes, size_t count);
+    // bytes为generator持有的数据量，计入CPU用量
+    void setSource(SourceGenerator generator, size_t bytes);
+    bool hasSource() const { return !sourceBoxes.empty() || static_cast<bool>(sourceGenerator); }
+
+    size_t cpuMemoryBytes() const;
+    size_t gpuMemoryBytes() const;
+
+    // 追加一个立方体的36个顶点（尚未上传，需要再调用setupMesh）
+    void addCube(const glm::vec3& position, const glm::vec3& size, const glm::vec3& color);
 
     // 基础形状创建函数
     static Model createCube(const glm::vec3& position, const glm::vec3& size, const glm::vec3& color);
@@ -27,7 +99,15 @@ public:
     static Model createCat(const glm::vec3& position, float scale);
 
 private:
-    void addCube(const glm::vec3& position, const glm::vec3& size, const glm::vec3& color);
+    std::vector<Box> sourceBoxes;     // GpuOnly模式下用于重建顶点的源数据
+    SourceGenerator sourceGenerator;  // 没有源方块时的重建函数
+    size_t sourceGeneratorBytes;
+
+    void createBuffers(size_t count, const Vertex* data);
+    void computeBounds();
+    void destroyBuffers();
+    // 把当前CPU端用量同步到MemoryTracker
+    void trackCpuMemory();
 };
 
 #endif // MODEL_H 
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef MODEL_BUILDER_H
+#define MODEL_BUILDER_H
+
+#include <glm/glm.hpp>
+#include <memory_resource>
+#include <vector>
+#include "Model.h"
+
+// 模型构建器
+// 先把方块记录到临时存储（默认使用每线程的内存池，构建多个模型时不再向系统申请内存），
+// finish时按方块数算出精确的顶点数，一次性分配顶点数组，再从常量立方体表直接写出顶点。
+class ModelBuilder {
+public:
+    static const size_t VERTICES_PER_BOX = 36;
+    static const size_t VERTICES_PER_FACE = 6;
+    static const int FACES_PER_BOX = 6;
+    // 立方体36个顶点相对中心的方向（乘以半尺寸得到偏移），顺序与面、三角形的绕序一致
+    static constexpr signed char CUBE_CORNERS[36][3] = {
+        // 前面 (Z+)
+        {-1, -1,  1}, { 1, -1,  1}, { 1,  1,  1},
+        {-1, -1,  1}, { 1,  1,  1}, {-1,  1,  1},
+        // 后面 (Z-)
+        { 1, -1, -1}, {-1, -1, -1}, {-1,  1, -1},
+        { 1, -1, -1}, {-1,  1, -1}, { 1,  1, -1},
+        // 右面 (X+)
+        { 1, -1,  1}, { 1, -1, -1}, { 1,  1, -1},
+        { 1, -1,  1}, { 1,  1, -1}, { 1,  1,  1},
+        // 左面 (X-)
+        {-1, -1, -1}, {-1, -1,  1}, {-1,  1,  1},
+        {-1, -1, -1}, {-1,  1,  1}, {-1,  1, -1},
+        // 上面 (Y+)
+        {-1,  1,  1}, { 1,  1,  1}, { 1,  1, -1},
+        {-1,  1,  1}, { 1,  1, -1}, {-1,  1, -1},
+        // 下面 (Y-)
+        {-1, -1, -1}, { 1, -1, -1}, { 1, -1,  1},
+        {-1, -1, -1}, { 1, -1,  1}, {-1, -1,  1}
+    };
+
+    // 每个面的法线（每面6个顶点）
+    static constexpr float CUBE_NORMALS[6][3] = {
+        { 0.0f,  0.0f,  1.0f},
+        { 0.0f,  0.0f, -1.0f},
+        { 1.0f,  0.0f,  0.0f},
+        {-1.0f,  0.0f,  0.0f},
+        { 0.0f,  1.0f,  0.0f},
+        { 0.0f, -1.0f,  0.0f}
+    };
+
+    // x + (-1)*w 与 x - w 在浮点上完全相同，因此生成的顶点与逐个列出坐标的写法一致
+    static constexpr float cornerOffset(float center, signed char sign, float half) {
+        return sign > 0 ? center + half : center - half;
+    }
+
+    // 方块数少于此值时直接生成比打开缓存文件更快
+    static const size_t MIN_CACHED_BOXES = 1024;
+
+    explicit ModelBuilder(std::pmr::memory_resource* scratch = threadScratch());
+
+    void reserve(size_t boxCount);
+    // 按颜色添加，颜色放入构建器的调色板
+    void addBox(const glm::vec3& position, const glm::vec3& size, const glm::vec3& color);
+    // 方块的color已经是调色板索引（调色板用setPalette给出）
+    void addBox(const Box& box);
+    void setPalette(const std::vector<glm::vec3>& colors);
+    const std::vector<glm::vec3>& getPalette() const { return palette; }
+    // 清空方块，保留调色板
+    void clear();
+
+    size_t boxCount() const { return boxes.size(); }
+    size_t vertexCount() const { return boxes.size() * VERTICES_PER_BOX; }
+    const std::pmr::vector<Box>& getBoxes() const { return boxes; }
+    // 所有方块的包围盒
+    void computeBounds(glm::vec3& boundsMin, glm::vec3& boundsMax) const;
+
+    // 将所有方块写入out（替换原内容，恰好分配一次）
+    void build(std::vector<Vertex>& out) const;
+    // 构建并上传，返回可绘制的模型（带构建器的调色板）
+    // GpuOnly模式下顶点直接写入映射的GPU缓冲，CPU端只保留源方块
+    // 设置了MeshCache::getDefault()且方块足够多时先查缓存，未命中则生成后写入
+    Model finish(Model::Residency residency = Model::defaultResidency) const;
+
+    // 写出单个方块的36个顶点，out至少要有VERTICES_PER_BOX个元素
+    static void writeBox(const Box& box, Vertex* out);
+    // 写出方块某一个面的6个顶点，面的顺序为 +Z、-Z、+X、-X、+Y、-Y
+    static void writeFace(const Box& box, int face, Vertex* out);
+
+    // 当前线程的临时内存池
+    static std::pmr::memory_resource* threadScratch();
+
+private:
+    std::pmr::vector<Box> boxes;
+    std::vector<glm::vec3> palette;
+};
+
+#endif
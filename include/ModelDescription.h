@@ -0,0 +1,86 @@
+#ifndef MODEL_DESCRIPTION_H
+#define MODEL_DESCRIPTION_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Model.h"
+
+// 文本模型描述
+// 用命名的部件、调色板和对称/重复操作描述方块模型，修改模型不需要重新编译。
+//
+//   # 注释
+//   model cat
+//   color main 0.6 0.6 0.6              调色板颜色（最多256个，顶点只存索引）
+//   color eye 1 1 1 material 1          可选的材质索引（相对实体的材质，见MaterialTable），默认0
+//   part leg                            部件定义，到end为止
+//     box 0 0.2 0  0.15 0.3 0.15 main   中心、尺寸、颜色名
+//   end
+//   use leg 0.2 0 0.3                   在给定偏移处放置部件
+//   mirror xz use leg 0.2 0 0.3         对称：沿x、z轴的所有镜像组合
+//   repeat 3 0 -0.03 0 box ...          重复：共3份，每份再平移(0,-0.03,0)
+//
+//   repeat 3 0.2 0 0 repeat 2 0 0.2 0 box ...   多个repeat取笛卡尔积：3x2的网格（总数不超过1024）
+//
+// mirror和repeat可以作为box或use的前缀并组合使用。部件外的box属于隐式的根部件。
+// 一行最多32个记号，超出时报错。
+// 加载时内容相同的部件会合并，每个不同的部件只生成一次网格，再按实例复制到模型中。
+//
+// 骨骼（PartTransforms中的部件索引）：
+//   part tail
+//     pivot 0 0.6 -0.5                  部件的旋转中心（部件空间，默认原点）
+//   use tail as tail                    实例的顶点属于骨骼tail，同名骨骼共用一个索引
+//   mirror xz use leg 0.2 0 0.3 as leg* 名字以*结尾时每个副本一根骨骼：leg0、leg1...
+// 没有as的实例属于骨骼0（root）。骨骼的旋转中心是第一个使用它的实例变换后的部件pivot。
+class ModelDescription {
+public:
+    struct Part {
+        std::string name;
+        std::vector<Box> boxes;
+        glm::vec3 pivot;
+        uint64_t hash;
+    };
+
+    // 部件实例：先按mirror（每轴±1）镜像，再平移offset，顶点属于骨骼bone
+    struct Instance {
+        size_t part;
+        glm::vec3 offset;
+        glm::vec3 mirror;
+        unsigned int bone;
+    };
+
+    // 骨骼：名字和模型空间的旋转中心
+    struct Bone {
+        std::string name;
+        glm::vec3 pivot;
+    };
+
+    std::string name;
+    std::vector<std::string> colorNames;
+    std::vector<glm::vec3> colors;
+    std::vector<unsigned int> colorMaterials;
+    std::vector<Part> parts;
+    std::vector<Instance> instances;
+    std::vector<Bone> bones;
+
+    // 解析文本，失败时error给出行号和原因
+    bool parse(const char* text, size_t length, std::string& error);
+    bool loadFile(const std::string& path);
+
+    size_t boxCount() const;
+    // 按名字查找骨骼索引，找不到时返回-1
+    int findBone(const std::string& boneName) const;
+    // 展开所有实例得到模型空间的方块（按position和scale变换）
+    void flatten(std::vector<Box>& out, const glm::vec3& position = glm::vec3(0.0f), float scale = 1.0f) const;
+
+    // 生成并上传模型：每个部件生成一次顶点，再变换到各个实例
+    Model build(const glm::vec3& position = glm::vec3(0.0f), float scale = 1.0f,
+                Model::Residency residency = Model::defaultResidency) const;
+
+private:
+    void dedupeParts();
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef PALETTE_ATLAS_H
+#define PALETTE_ATLAS_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+// 调色板图集
+// 每个调色板是纹理的一行（256列），顶点只存颜色在调色板中的索引，顶点着色器按(索引, 行)取色。
+// 同一个网格绘制时换一行就能换一套颜色（如猫的毛色），顶点缓冲不变。
+class PaletteAtlas {
+public:
+    // 与Model::MAX_PALETTE_COLORS一致
+    static const unsigned int COLORS = 256;
+    static const unsigned int MAX_PALETTES = 64;
+    // 着色器中palette采样器使用的纹理单元
+    static const unsigned int TEXTURE_UNIT = 1;
+
+    PaletteAtlas();
+    ~PaletteAtlas();
+    PaletteAtlas(const PaletteAtlas&) = delete;
+    PaletteAtlas& operator=(const PaletteAtlas&) = delete;
+
+    // 添加调色板，返回行号；图集满时给出警告并返回0
+    unsigned int add(const std::vector<glm::vec3>& colors);
+    // 替换某一行（如重新加载模型后）
+    void set(unsigned int palette, const std::vector<glm::vec3>& colors);
+    size_t size() const { return rows.size(); }
+
+    // 上传有改动的行，并把纹理绑定到TEXTURE_UNIT
+    void bind();
+
+private:
+    std::vector<std::vector<glm::vec3>> rows;
+    std::vector<char> dirtyRows;
+    unsigned int texture;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef PALETTE_LUT_H
+#define PALETTE_LUT_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 调色板量化查找表
+// 把RGB立方体按size^3个格点划分，每个格点预先算好OKLab空间中最近的调色板颜色的索引，
+// 存成R8UI的3D纹理；后处理阶段shaders/post/quantize.glsl对每个像素只需一次texelFetch，再从调色板纹理中取出颜色。
+// 生成时按切片分给JobSystem并行计算，结果按调色板和尺寸的哈希缓存到磁盘，之后启动时直接映射上传。
+//
+// 缓存文件布局（小端序）：
+//   Header（32字节）
+//   索引数据：size^3个uint8，r变化最快，其次g、b（与glTexImage3D的x、y、z一致）
+class PaletteLut {
+public:
+    static const uint32_t MAGIC = 0x4c334150;        // "PA3L"
+    static const uint32_t FORMAT_VERSION = 1;
+    // 修改颜色空间或最近色的计算方式时递增，旧缓存随之失效
+    static const uint32_t GENERATOR_VERSION = 1;
+    // 每个通道256个格点，8位颜色一一对应
+    static const unsigned int DEFAULT_SIZE = 256;
+    static const unsigned int MAX_COLORS = 256;
+    // shaders/post/quantize.glsl中quantize_lut和quantize_palette采样器使用的纹理单元
+    static const unsigned int LUT_TEXTURE_UNIT = 2;
+    static const unsigned int PALETTE_TEXTURE_UNIT = 3;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t formatVersion;
+        uint32_t generatorVersion;
+        uint32_t size;
+        uint64_t key;
+        uint32_t colorCount;
+        uint32_t reserved;
+    };
+
+    PaletteLut();
+    ~PaletteLut();
+    PaletteLut(const PaletteLut&) = delete;
+    PaletteLut& operator=(const PaletteLut&) = delete;
+
+    // 为palette准备查找表并上传：cacheDirectory非空时先查缓存，未命中则生成并写入缓存
+    // 调色板为空或超过MAX_COLORS种颜色时返回false
+    bool build(const std::vector<glm::vec3>& palette, unsigned int size = DEFAULT_SIZE,
+               const std::string& cacheDirectory = "lut_cache");
+    bool isReady() const { return lutTexture != 0; }
+    // 最近一次build是否命中了磁盘缓存，以及准备查找表的耗时
+    bool wasCached() const { return cached; }
+    double getBuildMs() const { return buildMs; }
+
+    unsigned int getSize() const { return size; }
+    const std::vector<glm::vec3>& getPalette() const { return palette; }
+
+    // 把查找表和调色板绑定到LUT_TEXTURE_UNIT/PALETTE_TEXTURE_UNIT
+    void bind() const;
+
+    // 在CPU上生成查找表，indices需要size^3字节
+    static void generate(const std::vector<glm::vec3>& palette, unsigned int size, uint8_t* indices);
+    // sRGB（0~1）转换到OKLab
+    static glm::vec3 toOklab(const glm::vec3& srgb);
+    // 查找表的缓存键（包含生成器版本和尺寸）
+    static uint64_t keyFor(const std::vector<glm::vec3>& palette, unsigned int size);
+
+    // 内置调色板：PICO-8的16色
+    static std::vector<glm::vec3> createPico8();
+
+private:
+    bool loadCache(const std::string& path, uint64_t key);
+    bool storeCache(const std::string& path, uint64_t key, const std::vector<uint8_t>& indices) const;
+    void upload(const uint8_t* indices);
+
+    std::vector<glm::vec3> palette;
+    unsigned int size;
+    unsigned int lutTexture;
+    unsigned int paletteTexture;
+    bool cached;
+    double buildMs;
+};
+
+#endif
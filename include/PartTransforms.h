@@ -0,0 +1,43 @@
+#ifndef PART_TRANSFORMS_H
+#define PART_TRANSFORMS_H
+
+#include <glm/glm.hpp>
+
+// 部件变换
+// 顶点在生成网格时带上部件（骨骼）索引，每个模型一组部件矩阵放在std140布局的uniform缓冲里，
+// 顶点着色器按索引取出矩阵，在模型矩阵之前应用。动画只需要每帧上传几个矩阵，顶点缓冲保持不变。
+class PartTransforms {
+public:
+    // 与vertex.glsl中的MAX_PARTS一致
+    static const unsigned int MAX_PARTS = 16;
+    // uniform块PartTransforms的绑定点
+    static const unsigned int BINDING = 0;
+
+    PartTransforms();
+    ~PartTransforms();
+    PartTransforms(const PartTransforms&) = delete;
+    PartTransforms& operator=(const PartTransforms&) = delete;
+
+    // 全部恢复为单位矩阵
+    void reset();
+    void set(unsigned int part, const glm::mat4& transform);
+    // 设置前count个部件（如AnimationSampler求出的姿态）
+    void set(const glm::mat4* transforms, unsigned int count);
+    // 设为绕pivot沿axis旋转angle弧度，parent不为单位矩阵时叠加在父部件之上
+    void rotate(unsigned int part, const glm::vec3& pivot, float angle, const glm::vec3& axis,
+                const glm::mat4& parent = glm::mat4(1.0f));
+    const glm::mat4& get(unsigned int part) const { return transforms[part]; }
+
+    // 上传有改动的矩阵（只到用到的最大部件为止）并绑定到BINDING，绘制模型前调用
+    void bind();
+    // 绑定所有部件都是单位矩阵的共享缓冲，用于没有动画的模型
+    static void bindIdentity();
+
+private:
+    glm::mat4 transforms[MAX_PARTS];
+    unsigned int UBO;
+    unsigned int usedParts;
+    bool dirty;
+};
+
+#endif
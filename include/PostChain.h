@@ -0,0 +1,105 @@
+#ifndef POST_CHAIN_H
+#define POST_CHAIN_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Shader.h"
+#include "RenderTargetPool.h"
+#include "ScreenQuad.h"
+
+// 后处理链
+// 每个效果是一段GLSL函数片段（shaders/post/<名字>.glsl），函数名与阶段名相同：
+//   Color阶段：vec4 <名字>(vec4 color, vec2 uv)，只依赖当前像素的颜色
+//   Sample阶段：vec4 <名字>(vec2 uv)，需要读取其他位置（邻域）的像素，通过sampleSource(uv)读取输入
+// 启用的阶段按顺序拼接成片段着色器：连续的Color阶段合并进同一个通道，只在Sample阶段之前断开，
+// 每个通道只读写一次整个目标。阶段的uniform以阶段名为前缀（如pixelate_size），由set*统一设置。
+// 通道之间的中间目标每帧从RenderTargetPool借用、用完即还；池中的目标可能大于有效区域，
+// sampleSource把[0, 1]的纹理坐标换算到有效区域内，阶段的片段不需要关心实际的纹理尺寸。
+class PostChain {
+public:
+    enum class StageKind {
+        Color,
+        Sample
+    };
+
+    explicit PostChain(RenderTargetPool& targetPool);
+    ~PostChain();
+    PostChain(const PostChain&) = delete;
+    PostChain& operator=(const PostChain&) = delete;
+
+    // 从文件读取阶段的片段；读取失败时输出错误并返回false
+    bool addStage(const std::string& name, StageKind kind, const std::string& path);
+    void addStageSource(const std::string& name, StageKind kind, const std::string& code);
+    void setEnabled(const std::string& name, bool enabled);
+    bool isEnabled(const std::string& name) const;
+    // 关闭合并时每个阶段单独一个通道（用于对比）
+    void setFusion(bool enabled);
+
+    void setInt(const std::string& name, int value);
+    void setFloat(const std::string& name, float value);
+    void setVec2(const std::string& name, const glm::vec2& value);
+    void setVec3(const std::string& name, const glm::vec3& value);
+
+    // 把input目标的有效区域经各通道输出到outputFramebuffer（0为屏幕）的outputWidth x outputHeight视口，
+    // 中间目标与输出同样大小；input可以小于输出（动态分辨率），第一个通道负责放大。
+    // 没有启用的阶段时直接复制。调用前绑定好阶段用到的其他纹理（如PaletteLut::bind）
+    void run(const RenderTargetPool::Target& input, unsigned int outputFramebuffer, int outputWidth, int outputHeight);
+
+    // 当前启用的阶段生成的通道数，以及每帧读写整个目标的估算字节数（按最近一次run的尺寸）
+    size_t getPassCount();
+    uint64_t getBandwidthBytes();
+    // 第pass个通道生成的片段着色器源码
+    std::string getPassSource(size_t pass);
+
+private:
+    struct Stage {
+        std::string name;
+        StageKind kind;
+        std::string code;
+        bool enabled;
+    };
+
+    struct Pass {
+        std::vector<size_t> stages;
+        Shader* program;
+    };
+
+    struct Uniform {
+        enum class Type {
+            Int,
+            Float,
+            Vec2,
+            Vec3
+        };
+        Type type;
+        int intValue;
+        glm::vec3 value;
+    };
+
+    void setUniform(const std::string& name, const Uniform& uniform);
+    void build();
+    std::string generate(const Pass& pass) const;
+
+    std::vector<Stage> stages;
+    std::vector<Pass> passes;
+    // 按生成的源码缓存编译好的程序，切换阶段时不重复编译
+    std::map<std::string, std::unique_ptr<Shader>> programs;
+    std::map<std::string, Uniform> uniforms;
+    // uniform每次改动递增；程序记录自己设置到的版本，只在落后时重新设置
+    uint64_t uniformVersion;
+    std::map<unsigned int, uint64_t> programVersions;
+    RenderTargetPool& targetPool;
+    ScreenQuad quad;
+    std::string vertexCode;
+    int width;
+    int height;
+    bool fusion;
+    bool dirty;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Shader;
+class Model;
+class PartTransforms;
+
+// 渲染队列
+// 每次绘制打包成一个64位排序键，每帧用基数排序排好后按顺序提交，只在程序、材质、网格、姿态变化时才切换GL状态。
+// 键从高到低依次为：
+//   不透明：阶段(4) | 着色器程序(8) | 材质(12) | 网格(16) | 深度(24)，状态相同的绘制由近到远（利于early-Z）
+//   半透明：阶段(4) | 反转深度(24) | 着色器程序(8) | 材质(12) | 网格(16)，由远到近
+class RenderQueue {
+public:
+    // 阶段按枚举值顺序提交
+    enum class Pass : uint8_t {
+        Opaque = 0,
+        Transparent = 1
+    };
+
+    struct Draw {
+        Shader* program;
+        uint32_t material;             // MaterialTable中的材质基址（uniform materialBase）
+        const Model* mesh;
+        uint32_t palette;              // PaletteAtlas中的行（uniform paletteRow），不参与排序
+        const glm::mat4* transform;    // 指向调用方的矩阵，提交前需保持有效
+        PartTransforms* pose;          // nullptr为单位矩阵
+    };
+
+    // 每次submit的状态切换次数
+    struct Stats {
+        uint32_t draws = 0;
+        uint32_t programChanges = 0;
+        uint32_t materialChanges = 0;
+        uint32_t meshChanges = 0;
+        uint32_t poseChanges = 0;
+        uint32_t paletteChanges = 0;
+    };
+
+    // 清空队列，depthRange为深度量化的范围（通常为远平面距离）
+    void clear(float depthRange);
+    // meshKey由调用方给出（如Scene中的ID），只用于排序，取低16位；材质取低12位；depth为到相机的距离
+    void push(Pass pass, uint32_t meshKey, float depth, const Draw& draw);
+    size_t size() const { return draws.size(); }
+
+    void sort();
+    // 按排序后的顺序绘制（需先调用sort）
+    void submit();
+    const Stats& getStats() const { return stats; }
+
+private:
+    uint32_t programKey(const Shader* program);
+
+    float depthScale = 0.0f;
+    std::vector<Draw> draws;
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> order;           // 排序后的绘制下标
+    std::vector<uint64_t> scratchKeys;
+    std::vector<uint32_t> scratchOrder;
+    std::vector<const Shader*> programs;   // 本帧出现的程序，下标即排序键中的程序编号
+    Stats stats;
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef RENDER_STATS_H
+#define RENDER_STATS_H
+
+#include <cstdint>
+
+// 渲染计数器：绘制调用、提交的顶点数、上传到GPU的字节数，以及经GLState发出和跳过的状态调用数
+// 由Model等模块累加，调用方按需在每帧开始时reset()
+struct RenderStats {
+    uint64_t drawCalls = 0;
+    uint64_t vertices = 0;
+    uint64_t uploadedBytes = 0;
+    uint64_t stateCalls = 0;
+    uint64_t stateCallsAvoided = 0;
+
+    void reset() {
+        drawCalls = 0;
+        vertices = 0;
+        uploadedBytes = 0;
+        stateCalls = 0;
+        stateCallsAvoided = 0;
+    }
+
+    // 全局计数器（渲染只在主线程进行）
+    static RenderStats& get() {
+        static RenderStats stats;
+        return stats;
+    }
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef RENDER_TARGET_POOL_H
+#define RENDER_TARGET_POOL_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Framebuffer.h"
+
+// 渲染目标池
+// 通道按(尺寸, 颜色格式, 是否带深度)在每帧内借用临时目标，用完归还；生命周期不重叠的通道共用同一组GL对象。
+// 分配的尺寸向上取整到BUCKET的倍数，请求的尺寸只是其中的有效区域（视口），
+// 因此拖动窗口时大部分帧直接复用已有目标；缩小时也可以复用空闲的更大目标。
+// 连续EVICT_FRAMES帧没有被借用的目标在endFrame时释放。
+class RenderTargetPool {
+public:
+    static const int BUCKET = 128;
+    static const uint64_t EVICT_FRAMES = 60;
+
+    struct Desc {
+        int width;
+        int height;
+        GLenum colorFormat = GL_RGB;
+        bool depth = false;
+    };
+
+    // 借出的目标：framebuffer的尺寸可能大于请求的width/height
+    struct Target {
+        Framebuffer* framebuffer = nullptr;
+        int width = 0;
+        int height = 0;
+
+        unsigned int texture() const { return framebuffer->texture; }
+        // 有效区域占整个纹理的比例，采样时乘到[0, 1]的纹理坐标上
+        glm::vec2 uvScale() const {
+            return glm::vec2(static_cast<float>(width) / framebuffer->getWidth(),
+                             static_cast<float>(height) / framebuffer->getHeight());
+        }
+        // 绑定帧缓冲并把视口设为有效区域
+        void bind() const;
+    };
+
+    struct Stats {
+        size_t liveTargets = 0;
+        size_t liveBytes = 0;
+        uint64_t allocations = 0;    // 新建的目标数（累计）
+        uint64_t reuses = 0;         // 直接复用已有目标的次数（累计）
+        uint64_t evictions = 0;
+    };
+
+    // bucket为尺寸取整的粒度，1时按请求的尺寸精确分配
+    explicit RenderTargetPool(int bucket = BUCKET);
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    Target acquire(const Desc& desc);
+    // 归还后同一帧中之后的acquire可以复用它
+    void release(const Target& target);
+    // 每帧结束时调用，释放长时间未使用的目标
+    void endFrame();
+    // 释放所有空闲目标
+    void trim();
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Entry {
+        std::unique_ptr<Framebuffer> framebuffer;
+        bool inUse;
+        uint64_t lastUsedFrame;
+    };
+
+    static size_t targetBytes(const Framebuffer& framebuffer);
+    void evict(size_t index);
+
+    std::vector<Entry> entries;
+    Stats stats;
+    int bucket;
+    uint64_t frame;
+};
+
+#endif
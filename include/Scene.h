@@ -0,0 +1,111 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Model.h"
+#include "Material.h"
+#include "MaterialTable.h"
+#include "PaletteAtlas.h"
+#include "PartTransforms.h"
+#include "RenderQueue.h"
+
+class Shader;
+
+// 场景
+// 实体引用共享的网格和材质，位置、朝向、缩放、世界矩阵、包围盒和可见性分别存放在连续数组中（SoA），
+// 变换更新、视锥剔除和向RenderQueue提交都是对这些数组的顺序遍历，帧循环中没有逐对象的堆节点和虚函数调用。
+// 实体用稳定的EntityId访问；删除时把最后一个实体移到空位，数组始终保持紧凑。
+class Scene {
+public:
+    using MeshId = uint32_t;
+    using MaterialId = uint32_t;
+    using EntityId = uint32_t;
+    using PaletteId = uint32_t;
+
+    // 实体不使用部件动画时的姿态
+    static constexpr uint32_t NO_POSE = 0xffffffffu;
+    // 实体使用网格自带的调色板
+    static constexpr PaletteId NO_PALETTE = 0xffffffffu;
+
+    // 实体数组，下标为紧凑索引（indexOf）；只读，修改通过Scene的setter以便标记需要更新的变换
+    struct Entities {
+        std::vector<glm::vec3> positions;
+        std::vector<float> yaws;               // 绕y轴的旋转（弧度）
+        std::vector<float> scales;
+        std::vector<glm::mat4> transforms;     // 世界矩阵
+        std::vector<glm::vec3> boundsMin;      // 世界空间包围盒
+        std::vector<glm::vec3> boundsMax;
+        std::vector<MeshId> meshes;
+        std::vector<MaterialId> materials;
+        std::vector<uint32_t> poses;           // 部件动画姿态（getPoseBuffer的索引）
+        std::vector<PaletteId> palettes;       // 换色用的调色板
+        std::vector<uint8_t> visible;
+        std::vector<uint8_t> dirty;            // 变换有改动，等待updateTransforms
+        std::vector<EntityId> ids;
+    };
+
+    // 网格的调色板同时加入调色板图集
+    MeshId addMesh(Model&& model);
+    // 替换网格（如重新加载），引用它的实体重新计算包围盒
+    void setMesh(MeshId mesh, Model&& model);
+    PaletteId getMeshPalette(MeshId mesh) const { return meshPalettes[mesh]; }
+    const Model& getMesh(MeshId mesh) const { return meshes[mesh]; }
+    size_t getMeshCount() const { return meshes.size(); }
+
+    // 材质放在MaterialTable中；连续添加的材质索引连续，多材质网格的顶点材质索引相对于实体的材质
+    MaterialId addMaterial(const Material& material);
+    const Material& getMaterial(MaterialId material) const { return materials.get(material); }
+
+    // 额外的调色板（如猫的其他毛色），颜色索引与网格的调色板对应
+    PaletteId addPalette(const std::vector<glm::vec3>& colors);
+
+    EntityId createEntity(MeshId mesh, MaterialId material, const glm::vec3& position = glm::vec3(0.0f),
+                          float yaw = 0.0f, float scale = 1.0f);
+    void destroyEntity(EntityId entity);
+    size_t getEntityCount() const { return entities.ids.size(); }
+    uint32_t indexOf(EntityId entity) const { return entityIndex[entity]; }
+    const Entities& getEntities() const { return entities; }
+
+    void setPosition(EntityId entity, const glm::vec3& position);
+    void setYaw(EntityId entity, float yaw);
+    void setScale(EntityId entity, float scale);
+    void setPose(EntityId entity, uint32_t pose);
+    // 换调色板不改动顶点缓冲；NO_PALETTE恢复网格自带的调色板
+    void setPalette(EntityId entity, PaletteId palette);
+
+    // 修改计数：增删实体、网格、材质、调色板以及调用setter时递增（不包括姿态缓冲的内容），
+    // 按需渲染时与上次绘制时的值比较，判断场景是否需要重绘
+    uint64_t getRevision() const { return revision; }
+
+    // 部件动画的姿态缓冲，按需创建，多个实体可以共用同一个姿态
+    PartTransforms& getPoseBuffer(uint32_t pose);
+
+    // 重新计算有改动的实体的世界矩阵和包围盒
+    void updateTransforms();
+    // 用视锥剔除，得到可见实体的紧凑索引列表，返回可见数量（创建或删除实体后需要重新剔除）
+    size_t cull(const glm::mat4& viewProjection);
+    const std::vector<uint32_t>& getVisible() const { return visibleList; }
+
+    // 上传并绑定材质表和调色板图集，把可见实体作为不透明绘制加入队列，按到viewPosition的距离排序；提交前不要修改场景
+    void submit(RenderQueue& queue, Shader& shader, const glm::vec3& viewPosition);
+
+private:
+    std::vector<Model> meshes;
+    std::vector<PaletteId> meshPalettes;
+    MaterialTable materials;
+    PaletteAtlas paletteAtlas;
+    std::vector<std::unique_ptr<PartTransforms>> poseBuffers;
+
+    Entities entities;
+    std::vector<uint32_t> entityIndex;     // EntityId -> 紧凑索引
+    std::vector<EntityId> freeIds;
+
+    std::vector<uint32_t> visibleList;
+    uint64_t revision = 0;
+};
+
+#endif
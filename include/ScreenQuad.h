@@ -0,0 +1,21 @@
+#ifndef SCREEN_QUAD_H
+#define SCREEN_QUAD_H
+
+// 全屏四边形
+// 后处理通道（shaders/post/screen.vs）使用：位置为裁剪空间的[-1, 1]，纹理坐标为[0, 1]。
+class ScreenQuad {
+public:
+    ScreenQuad();
+    ~ScreenQuad();
+    ScreenQuad(const ScreenQuad&) = delete;
+    ScreenQuad& operator=(const ScreenQuad&) = delete;
+
+    // 调用前设置好着色器和输入纹理；关闭深度测试
+    void draw() const;
+
+private:
+    unsigned int VAO;
+    unsigned int VBO;
+};
+
+#endif
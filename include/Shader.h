@@ -16,6 +16,8 @@ public:
 
     // 构造器
     Shader(const char* vertexPath, const char* fragmentPath);
+    // 由源码直接编译（如PostChain生成的片段着色器），出错时与文件版本一样输出日志
+    static Shader fromSource(const std::string& vertexCode, const std::string& fragmentCode);
 
     // 使用/激活程序
     void use();
@@ -24,11 +26,16 @@ public:
     void setBool(const std::string &name, bool value) const;
     void setInt(const std::string &name, int value) const;
     void setFloat(const std::string &name, float value) const;
+    void setVec2(const std::string &name, const glm::vec2 &value) const;
     void setVec3(const std::string &name, const glm::vec3 &value) const;
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
+    // 把uniform块绑定到指定绑定点，着色器中没有该块时忽略
+    void bindUniformBlock(const std::string &name, unsigned int binding) const;
 
 private:
-    void checkCompileErrors(unsigned int shader, std::string type);
+    Shader() : ID(0) {}
+    bool compile(const std::string& vertexCode, const std::string& fragmentCode);
+    bool checkCompileErrors(unsigned int shader, std::string type);
 };
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef VOX_LOADER_H
+#define VOX_LOADER_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Model.h"
+
+// MagicaVoxel模型（体素数据直接指向映射的文件内容，不做拷贝）
+struct VoxModelView {
+    glm::ivec3 size;
+    const unsigned char* xyzi;     // 每个体素4字节：x, y, z, 调色板索引
+    uint32_t voxelCount;
+};
+
+// 场景图中的一个模型实例（nTRN/nGRP/nSHP展开后的结果，坐标为MagicaVoxel的Z向上空间）
+struct VoxInstance {
+    uint32_t model;
+    glm::mat3 rotation;
+    glm::vec3 translation;
+};
+
+// .vox文件
+// 文件以只读方式映射到内存，解析时只记录各块的位置：SIZE/XYZI成为指向映射区的模型视图，
+// RGBA读入256色调色板，nTRN/nGRP/nSHP场景图展开为实例列表。
+class VoxFile {
+public:
+    VoxFile();
+    ~VoxFile();
+
+    VoxFile(const VoxFile&) = delete;
+    VoxFile& operator=(const VoxFile&) = delete;
+
+    bool open(const std::string& path);
+    // 解析内存中的数据（调用方保证data在VoxFile使用期间有效）
+    bool openMemory(const void* data, size_t size);
+    void close();
+
+    const std::vector<VoxModelView>& getModels() const { return models; }
+    // 没有场景图时每个模型对应一个原点处的实例
+    const std::vector<VoxInstance>& getInstances() const { return instances; }
+    // 调色板（RGBA，每通道8位），索引0表示空
+    const uint32_t* getPalette() const { return palette; }
+    glm::vec3 paletteColor(unsigned char index) const;
+    // 文件原始内容
+    const unsigned char* getData() const { return data; }
+    size_t getSize() const { return dataSize; }
+    // open的文件路径和修改时间（纳秒），openMemory时为空和0；用作缓存键，代替哈希整个文件
+    const std::string& getPath() const { return filePath; }
+    int64_t getModifiedTime() const { return modifiedTime; }
+
+private:
+    struct SceneNode;
+
+    const unsigned char* data;
+    size_t dataSize;
+    void* mapping;
+    size_t mappingSize;
+    std::vector<unsigned char> fileData;    // 不支持mmap的平台上读入的文件内容
+    std::string filePath;
+    int64_t modifiedTime;
+    std::vector<VoxModelView> models;
+    std::vector<VoxInstance> instances;
+    uint32_t palette[256];
+
+    bool parse();
+};
+
+// 体素网格生成：只输出相邻格子为空的面
+class VoxMesher {
+public:
+    // 生成单个模型的顶点（体素单位，模型中心在原点），out被替换
+    static void mesh(const VoxModelView& model, std::vector<Vertex>& out);
+};
+
+// 加载.vox文件为一个模型：各模型并行生成网格，再按场景图实例合并上传。
+// 坐标从MagicaVoxel的Z向上转换为Y向上，每个体素边长为voxelSize。
+// 第i个实例的顶点属于部件i（从PartTransforms::MAX_PARTS个起归入部件0），可以分别做动画。
+// 设置了MeshCache::getDefault()时查缓存，命中则跳过网格生成：从磁盘打开的文件以大小、修改时间和
+// 抽样内容为键，内存中的数据哈希全部内容。
+// GpuOnly模式下模型记住文件路径（内存中的数据则保留一份副本）作为源数据，ensureCpuData时重新生成合并后的顶点。
+class VoxLoader {
+public:
+    // parallel为true时各模型的网格生成和实例合并分给JobSystem::get()的线程池（此时不能在JobSystem的任务中调用），
+    // 为false时全部在调用线程执行
+    static bool load(const std::string& path, Model& model, float voxelSize = 0.1f, bool parallel = true);
+    static bool load(const VoxFile& file, Model& model, float voxelSize = 0.1f, bool parallel = true);
+};
+
+#endif
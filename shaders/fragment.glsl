@@ -2,10 +2,13 @@
 in vec3 FragPos;
 in vec3 Normal;
 in vec3 Color;
+flat in int MaterialIndex;
 
 out vec4 FragOutput;
 
 #define MAX_LIGHTS 4
+// 与MaterialTable::MAX_MATERIALS一致
+#define MAX_MATERIALS 64
 
 struct Material {
     vec3 ambient;
@@ -24,12 +27,22 @@ struct Light {
     float quadratic;
 };
 
+// 材质表（绑定点MaterialTable::BINDING），vec3按vec4对齐，高光锐度在specular.w
+struct MaterialData {
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+};
+
+layout (std140) uniform Materials {
+    MaterialData materials[MAX_MATERIALS];
+};
+
 uniform vec3 viewPos;
-uniform Material material;
 uniform Light lights[MAX_LIGHTS];
 uniform int numLights;
 
-vec3 CalcLight(Light light, vec3 normal, vec3 fragPos, vec3 viewDir) {
+vec3 CalcLight(Light light, Material material, vec3 normal, vec3 fragPos, vec3 viewDir) {
     // 计算光照方向和距离
     vec3 lightDir = normalize(light.position - fragPos);
     float distance = length(light.position - fragPos);
@@ -58,12 +71,14 @@ vec3 CalcLight(Light light, vec3 normal, vec3 fragPos, vec3 viewDir) {
 void main() {
     vec3 norm = normalize(Normal);
     vec3 viewDir = normalize(viewPos - FragPos);
+    MaterialData data = materials[MaterialIndex];
+    Material material = Material(data.ambient.xyz, data.diffuse.xyz, data.specular.xyz, data.specular.w);
     
     vec3 result = vec3(0.0);
     
     // 计算所有光源的贡献
     for(int i = 0; i < numLights; i++) {
-        result += CalcLight(lights[i], norm, FragPos, viewDir);
+        result += CalcLight(lights[i], material, norm, FragPos, viewDir);
     }
     
     // 应用颜色
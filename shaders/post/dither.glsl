@@ -0,0 +1,16 @@
+// 4x4有序抖动：按屏幕位置加上Bayer阈值，之后的量化阶段把颜色分散到相邻的调色板颜色
+uniform float dither_strength;    // 阈值的幅度，0时不改变颜色
+uniform float dither_scale;       // 每个抖动格子的屏幕像素数（与像素化的块大小一致）
+
+const float DITHER_BAYER[16] = float[16](
+     0.0,  8.0,  2.0, 10.0,
+    12.0,  4.0, 14.0,  6.0,
+     3.0, 11.0,  1.0,  9.0,
+    15.0,  7.0, 13.0,  5.0
+);
+
+vec4 dither(vec4 color, vec2 uv) {
+    ivec2 cell = ivec2(floor(gl_FragCoord.xy / dither_scale)) & 3;
+    float threshold = (DITHER_BAYER[cell.y * 4 + cell.x] + 0.5) / 16.0 - 0.5;
+    return vec4(color.rgb + threshold * dither_strength, color.a);
+}
@@ -0,0 +1,15 @@
+// 描边：与右侧、上方相邻像素块的亮度差超过阈值时换成描边颜色（线宽为一个像素块）
+// 读取相邻像素，只能作为通道的第一个阶段
+uniform vec2 outline_step;        // 相邻像素块的距离（纹理坐标，与像素化的块大小一致）
+uniform float outline_threshold;
+uniform vec3 outline_color;
+
+vec4 outline(vec2 uv) {
+    const vec3 LUMA = vec3(0.299, 0.587, 0.114);
+    vec4 color = sampleSource(uv);
+    float center = dot(color.rgb, LUMA);
+    float right = dot(sampleSource(uv + vec2(outline_step.x, 0.0)).rgb, LUMA);
+    float up = dot(sampleSource(uv + vec2(0.0, outline_step.y)).rgb, LUMA);
+    float edge = max(abs(center - right), abs(center - up));
+    return vec4(mix(color.rgb, outline_color, step(outline_threshold, edge)), color.a);
+}
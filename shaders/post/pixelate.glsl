@@ -0,0 +1,11 @@
+// 像素化：每个像素块取块中心的颜色
+// 读取其他位置的像素，只能作为通道的第一个阶段
+uniform vec2 pixelate_size; // 像素块大小（纹理坐标）
+
+vec4 pixelate(vec2 uv) {
+    vec2 pixelCoord = vec2(
+        floor(uv.x / pixelate_size.x) * pixelate_size.x + pixelate_size.x * 0.5,
+        floor(uv.y / pixelate_size.y) * pixelate_size.y + pixelate_size.y * 0.5
+    );
+    return sampleSource(pixelCoord);
+}
@@ -0,0 +1,10 @@
+// 调色板量化：经PaletteLut的3D查找表映射到最近的调色板颜色
+uniform usampler3D quantize_lut;      // lutSize^3个格点，每个格点存调色板颜色索引
+uniform sampler2D quantize_palette;
+uniform int quantize_lutSize;
+
+vec4 quantize(vec4 color, vec2 uv) {
+    ivec3 coord = ivec3(clamp(color.rgb, 0.0, 1.0) * float(quantize_lutSize - 1) + 0.5);
+    uint index = texelFetch(quantize_lut, coord, 0).r;
+    return vec4(texelFetch(quantize_palette, ivec2(int(index), 0), 0).rgb, 1.0);
+}
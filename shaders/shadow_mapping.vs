@@ -1,9 +1,16 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+layout (location = 3) in uint aPart;
+
+#define MAX_PARTS 16
 
 uniform mat4 lightSpaceMatrix;
 uniform mat4 model;
 
+layout (std140) uniform PartTransforms {
+    mat4 parts[MAX_PARTS];
+};
+
 void main() {
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
-} 
\ No newline at end of file
+    gl_Position = lightSpaceMatrix * model * parts[min(aPart, uint(MAX_PARTS - 1))] * vec4(aPos, 1.0);
+}
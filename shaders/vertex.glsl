@@ -1,27 +1,46 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
+layout (location = 1) in uint aColor;
 layout (location = 2) in vec3 aNormal;
+layout (location = 3) in uint aPart;
+layout (location = 4) in uint aMaterial;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec3 Color;
+flat out int MaterialIndex;
+
+// 与PartTransforms::MAX_PARTS、MaterialTable::MAX_MATERIALS一致
+#define MAX_PARTS 16
+#define MAX_MATERIALS 64
 
 uniform mat4 model;
+// 本次绘制的材质基址，顶点的材质索引相对于它
+uniform int materialBase;
+// 调色板图集（PaletteAtlas）：列为颜色索引，行为本次绘制使用的调色板
+uniform sampler2D palette;
+uniform int paletteRow;
 uniform mat4 view;
 uniform mat4 projection;
 
+// 部件变换（每个模型一组，绑定点PartTransforms::BINDING），在模型矩阵之前应用
+layout (std140) uniform PartTransforms {
+    mat4 parts[MAX_PARTS];
+};
+
 void main() {
     // 计算世界空间位置
-    vec4 worldPos = model * vec4(aPos, 1.0);
+    mat4 partModel = model * parts[min(aPart, uint(MAX_PARTS - 1))];
+    vec4 worldPos = partModel * vec4(aPos, 1.0);
     FragPos = vec3(worldPos);
     
     // 计算法线
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = mat3(transpose(inverse(partModel))) * aNormal;
     
-    // 传递颜色
-    Color = aColor;
+    // 传递颜色和材质
+    Color = texelFetch(palette, ivec2(int(aColor), paletteRow), 0).rgb;
+    MaterialIndex = min(materialBase + int(aMaterial), MAX_MATERIALS - 1);
     
     // 计算裁剪空间位置
     gl_Position = projection * view * worldPos;
-} 
\ No newline at end of file
+}
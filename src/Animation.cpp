@@ -0,0 +1,306 @@
+#include "Animation.h"
+#include "BuiltinModels.h"
+#include "JobSystem.h"
+#include "PartTransforms.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// 每条正弦曲线的关键帧数（首尾相同，循环无缝）
+const int SINE_KEYS = 17;
+
+// 在整个片段上按正弦摆动：angle = amplitude * sin(2π * cycles * t / duration + phase) + offset
+void addSineRotation(AnimationClip& clip, unsigned int part, const glm::vec3& axis, float amplitude,
+                     int cycles, float phase, float offset = 0.0f) {
+    for (int k = 0; k < SINE_KEYS; k++) {
+        float t = clip.duration * k / (SINE_KEYS - 1);
+        float angle = amplitude * std::sin(2.0f * static_cast<float>(M_PI) * cycles * k / (SINE_KEYS - 1) + phase);
+        clip.addRotationKey(part, t, angle + offset, axis);
+    }
+}
+
+}
+
+Skeleton Skeleton::createCat() {
+    using namespace BuiltinModels;
+    Skeleton skeleton;
+    for (int part = 0; part < CatPartCount; part++) {
+        skeleton.parents.push_back(CAT_PART_PARENTS[part]);
+        skeleton.pivots.push_back(glm::vec3(CAT_PART_PIVOTS[part][0], CAT_PART_PIVOTS[part][1],
+                                            CAT_PART_PIVOTS[part][2]));
+    }
+    return skeleton;
+}
+
+AnimationClip::Curve& AnimationClip::curveFor(unsigned int part, Target target) {
+    for (Curve& curve : curves) {
+        if (curve.part == part && curve.target == target) {
+            return curve;
+        }
+    }
+    curves.push_back(Curve{part, target, {}, {}, {}, {}, {}});
+    return curves.back();
+}
+
+void AnimationClip::addRotationKey(unsigned int part, float time, float angle, const glm::vec3& axis) {
+    glm::vec3 unit = glm::normalize(axis);
+    float s = std::sin(angle * 0.5f);
+    Curve& curve = curveFor(part, Target::Rotation);
+    curve.times.push_back(time);
+    curve.x.push_back(unit.x * s);
+    curve.y.push_back(unit.y * s);
+    curve.z.push_back(unit.z * s);
+    curve.w.push_back(std::cos(angle * 0.5f));
+    duration = std::max(duration, time);
+}
+
+void AnimationClip::addTranslationKey(unsigned int part, float time, const glm::vec3& translation) {
+    Curve& curve = curveFor(part, Target::Translation);
+    curve.times.push_back(time);
+    curve.x.push_back(translation.x);
+    curve.y.push_back(translation.y);
+    curve.z.push_back(translation.z);
+    duration = std::max(duration, time);
+}
+
+AnimationClip AnimationClip::createCatIdle() {
+    using namespace BuiltinModels;
+    const glm::vec3 xAxis(1.0f, 0.0f, 0.0f);
+    const glm::vec3 yAxis(0.0f, 1.0f, 0.0f);
+
+    AnimationClip clip;
+    clip.name = "cat_idle";
+    clip.duration = 2.0f;
+    // 尾巴左右摆动，后半段滞后一些形成波动
+    addSineRotation(clip, CatTail, yAxis, 0.35f, 3, 0.0f);
+    addSineRotation(clip, CatTailTip, yAxis, 0.5f, 3, -0.8f);
+    // 轻微点头
+    addSineRotation(clip, CatHead, xAxis, 0.08f, 1, 0.0f);
+    return clip;
+}
+
+AnimationClip AnimationClip::createCatWalk() {
+    using namespace BuiltinModels;
+    const glm::vec3 xAxis(1.0f, 0.0f, 0.0f);
+    const glm::vec3 yAxis(0.0f, 1.0f, 0.0f);
+    const float pi = static_cast<float>(M_PI);
+
+    AnimationClip clip;
+    clip.name = "cat_walk";
+    clip.duration = 1.0f;
+    // 对角的两条腿同相
+    addSineRotation(clip, CatLegFrontLeft, xAxis, 0.35f, 1, 0.0f);
+    addSineRotation(clip, CatLegBackRight, xAxis, 0.35f, 1, 0.0f);
+    addSineRotation(clip, CatLegFrontRight, xAxis, 0.35f, 1, pi);
+    addSineRotation(clip, CatLegBackLeft, xAxis, 0.35f, 1, pi);
+    // 每步身体起伏一次
+    for (int k = 0; k < SINE_KEYS; k++) {
+        float t = clip.duration * k / (SINE_KEYS - 1);
+        float bob = 0.02f * std::fabs(std::sin(2.0f * pi * k / (SINE_KEYS - 1)));
+        clip.addTranslationKey(CatBody, t, glm::vec3(0.0f, bob, 0.0f));
+    }
+    // 尾巴翘起并随步伐轻摆
+    addSineRotation(clip, CatTail, xAxis, 0.05f, 2, 0.0f, -0.3f);
+    addSineRotation(clip, CatTailTip, yAxis, 0.2f, 1, 0.0f);
+    addSineRotation(clip, CatHead, xAxis, 0.04f, 2, 0.5f);
+    return clip;
+}
+
+AnimationSampler::AnimationSampler(const Skeleton& skeleton, float sampleRate)
+    : skeleton(skeleton), sampleRate(sampleRate) {
+    if (skeleton.partCount() > PartTransforms::MAX_PARTS) {
+        std::cerr << "Warning: skeleton has " << skeleton.partCount() << " parts, only the first "
+                  << PartTransforms::MAX_PARTS << " are animated" << std::endl;
+        this->skeleton.parents.resize(PartTransforms::MAX_PARTS);
+        this->skeleton.pivots.resize(PartTransforms::MAX_PARTS);
+    }
+}
+
+size_t AnimationSampler::addClip(const AnimationClip& clip) {
+    clips.push_back(clip);
+    uint32_t frames = 1;
+    if (sampleRate > 0.0f) {
+        frames = std::max(1u, static_cast<uint32_t>(std::ceil(clip.duration * sampleRate)));
+    }
+    clipFirstSlot.push_back(static_cast<uint32_t>(slots.size()));
+    clipFrames.push_back(frames);
+    slots.resize(slots.size() + frames, -1);
+    return clips.size() - 1;
+}
+
+void AnimationSampler::evaluate(const Instance* instances, size_t count) {
+    PROFILE_FUNCTION();
+
+    instancePoses.resize(count);
+    poseClips.clear();
+    poseTimes.clear();
+    if (clips.empty()) {
+        return;
+    }
+
+    // 量化时间并合并相同的姿态
+    bool shared = sampleRate > 0.0f;
+    if (shared) {
+        std::fill(slots.begin(), slots.end(), -1);
+    }
+    for (size_t i = 0; i < count; i++) {
+        uint32_t clip = instances[i].clip < clips.size() ? instances[i].clip : 0;
+        float duration = clips[clip].duration;
+        float time = duration > 0.0f ? std::fmod(instances[i].time, duration) : 0.0f;
+        if (time < 0.0f) {
+            time += duration;
+        }
+        if (!shared) {
+            instancePoses[i] = static_cast<uint32_t>(poseClips.size());
+            poseClips.push_back(clip);
+            poseTimes.push_back(time);
+            continue;
+        }
+        uint32_t frame = static_cast<uint32_t>(time * sampleRate + 0.5f);
+        if (frame >= clipFrames[clip]) {
+            frame = 0;    // 最后一帧与第一帧相同
+        }
+        int32_t& slot = slots[clipFirstSlot[clip] + frame];
+        if (slot < 0) {
+            slot = static_cast<int32_t>(poseClips.size());
+            poseClips.push_back(clip);
+            poseTimes.push_back(frame / sampleRate);
+        }
+        instancePoses[i] = static_cast<uint32_t>(slot);
+    }
+
+    // 按片段分组，每批只包含同一片段的姿态
+    size_t poseCount = poseClips.size();
+    clipStart.assign(clips.size() + 1, 0);
+    for (uint32_t clip : poseClips) {
+        clipStart[clip + 1]++;
+    }
+    for (size_t c = 0; c < clips.size(); c++) {
+        clipStart[c + 1] += clipStart[c];
+    }
+    clipCursor.assign(clipStart.begin(), clipStart.end() - 1);
+    poseOrder.resize(poseCount);
+    for (size_t p = 0; p < poseCount; p++) {
+        poseOrder[clipCursor[poseClips[p]]++] = static_cast<uint32_t>(p);
+    }
+    batches.clear();
+    for (size_t c = 0; c < clips.size(); c++) {
+        for (uint32_t begin = clipStart[c]; begin < clipStart[c + 1]; begin += BATCH) {
+            batches.emplace_back(begin, std::min<uint32_t>(begin + BATCH, clipStart[c + 1]) - begin);
+        }
+    }
+
+    poses.resize(poseCount * skeleton.partCount());
+    JobSystem::get().parallelFor(batches.size(), 1, [this](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            sampleBatch(&poseOrder[batches[b].first], batches[b].second);
+        }
+    });
+}
+
+void AnimationSampler::sampleBatch(const uint32_t* batch, size_t lanes) {
+    const AnimationClip& clip = clips[poseClips[batch[0]]];
+    size_t partCount = skeleton.partCount();
+
+    // 每个部件每条通道的局部变换（SoA：分量 x 部件 x 姿态）
+    float rotation[4][PartTransforms::MAX_PARTS][BATCH];
+    float translation[3][PartTransforms::MAX_PARTS][BATCH];
+    for (size_t part = 0; part < partCount; part++) {
+        for (size_t lane = 0; lane < lanes; lane++) {
+            rotation[0][part][lane] = rotation[1][part][lane] = rotation[2][part][lane] = 0.0f;
+            rotation[3][part][lane] = 1.0f;
+            translation[0][part][lane] = translation[1][part][lane] = translation[2][part][lane] = 0.0f;
+        }
+    }
+
+    float times[BATCH];
+    for (size_t lane = 0; lane < lanes; lane++) {
+        times[lane] = poseTimes[batch[lane]];
+    }
+
+    float alpha[BATCH];
+    float a[4][BATCH];
+    float b[4][BATCH];
+    for (const AnimationClip::Curve& curve : clip.curves) {
+        if (curve.part >= partCount || curve.times.empty()) {
+            continue;
+        }
+        bool isRotation = curve.target == AnimationClip::Target::Rotation;
+        int components = isRotation ? 4 : 3;
+        const float* channels[4] = {curve.x.data(), curve.y.data(), curve.z.data(), curve.w.data()};
+
+        // 查找关键帧并取出两端的值
+        size_t keys = curve.times.size();
+        for (size_t lane = 0; lane < lanes; lane++) {
+            size_t k1 = std::upper_bound(curve.times.begin(), curve.times.end(), times[lane]) - curve.times.begin();
+            k1 = std::min(std::max<size_t>(k1, 1), keys - 1);
+            size_t k0 = keys > 1 ? k1 - 1 : 0;
+            float span = curve.times[k1] - curve.times[k0];
+            float t = span > 0.0f ? (times[lane] - curve.times[k0]) / span : 0.0f;
+            alpha[lane] = std::min(std::max(t, 0.0f), 1.0f);
+            for (int c = 0; c < components; c++) {
+                a[c][lane] = channels[c][k0];
+                b[c][lane] = channels[c][k1];
+            }
+        }
+
+        // 逐分量插值，循环内没有分支，编译器可以向量化
+        if (isRotation) {
+            float* out[4] = {rotation[0][curve.part], rotation[1][curve.part],
+                             rotation[2][curve.part], rotation[3][curve.part]};
+            for (size_t lane = 0; lane < lanes; lane++) {
+                float dot = a[0][lane] * b[0][lane] + a[1][lane] * b[1][lane] +
+                            a[2][lane] * b[2][lane] + a[3][lane] * b[3][lane];
+                // 走较短的一侧
+                float wb = dot < 0.0f ? -alpha[lane] : alpha[lane];
+                float wa = 1.0f - alpha[lane];
+                float x = a[0][lane] * wa + b[0][lane] * wb;
+                float y = a[1][lane] * wa + b[1][lane] * wb;
+                float z = a[2][lane] * wa + b[2][lane] * wb;
+                float w = a[3][lane] * wa + b[3][lane] * wb;
+                float inverse = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+                out[0][lane] = x * inverse;
+                out[1][lane] = y * inverse;
+                out[2][lane] = z * inverse;
+                out[3][lane] = w * inverse;
+            }
+        }
+        else {
+            for (int c = 0; c < 3; c++) {
+                float* out = translation[c][curve.part];
+                for (size_t lane = 0; lane < lanes; lane++) {
+                    out[lane] = a[c][lane] + (b[c][lane] - a[c][lane]) * alpha[lane];
+                }
+            }
+        }
+    }
+
+    // 组合成模型空间矩阵：绕pivot旋转再平移，叠加在父部件之上
+    for (size_t lane = 0; lane < lanes; lane++) {
+        glm::mat4* pose = &poses[batch[lane] * partCount];
+        for (size_t part = 0; part < partCount; part++) {
+            float x = rotation[0][part][lane];
+            float y = rotation[1][part][lane];
+            float z = rotation[2][part][lane];
+            float w = rotation[3][part][lane];
+            glm::mat3 r(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y),
+                        2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x),
+                        2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y));
+            const glm::vec3& pivot = skeleton.pivots[part];
+            glm::vec3 offset = pivot - r * pivot +
+                glm::vec3(translation[0][part][lane], translation[1][part][lane], translation[2][part][lane]);
+
+            glm::mat4 local(r);
+            local[3] = glm::vec4(offset, 1.0f);
+            int parent = skeleton.parents[part];
+            pose[part] = parent >= 0 ? pose[parent] * local : local;
+        }
+    }
+}
@@ -1,7 +1,8 @@
 #include "Camera.h"
 #include <algorithm>
 
-Camera::Camera(float radius) : 
+Camera::Camera(float radius) :
+    Position(glm::vec3(0.0f)),
     Target(glm::vec3(0.0f)),
     Up(glm::vec3(0.0f, 1.0f, 0.0f)),
     Radius(radius),
@@ -9,7 +10,8 @@ Camera::Camera(float radius) :
     Pitch(30.0f),
     MovementSpeed(2.5f),
     RotationSpeed(50.0f),
-    ZoomSpeed(2.0f)
+    ZoomSpeed(2.0f),
+    changed(true)
 {
     updateCameraPosition();
 }
@@ -58,5 +60,16 @@ void Camera::updateCameraPosition() {
     float y = Radius * sin(glm::radians(Pitch));
     float z = Radius * cos(glm::radians(Pitch)) * sin(glm::radians(Yaw));
     
-    Position = Target + glm::vec3(x, y, z);
+    glm::vec3 position = Target + glm::vec3(x, y, z);
+    // 在俯仰或缩放的限制处继续按键时位置不变，不需要重绘
+    if (position != Position) {
+        Position = position;
+        changed = true;
+    }
+}
+
+bool Camera::ConsumeChanged() {
+    bool result = changed;
+    changed = false;
+    return result;
 } 
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "Diagnostics.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+uint64_t messageKey(GLenum source, GLenum type, GLuint id) {
+    return (static_cast<uint64_t>(source & 0xffff) << 48) | (static_cast<uint64_t>(type & 0xffff) << 32) | id;
+}
+
+}
+
+Diagnostics& Diagnostics::get() {
+    static Diagnostics instance;
+    return instance;
+}
+
+Diagnostics::Diagnostics()
+    : level(Level::Off), writePosition(0), readPosition(0), dropped(0), messageCount(0) {
+    // 槽位的序号等于下一次可以写入它的位置
+    for (size_t i = 0; i < RING_SIZE; i++) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool Diagnostics::parseLevel(const std::string& name, Level& result) {
+    for (Level candidate : {Level::Off, Level::Async, Level::Sync}) {
+        if (name == levelName(candidate)) {
+            result = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* Diagnostics::levelName(Level level) {
+    switch (level) {
+        case Level::Off:
+            return "off";
+        case Level::Async:
+            return "async";
+        case Level::Sync:
+            return "sync";
+    }
+    return "unknown";
+}
+
+Diagnostics::Level Diagnostics::defaultLevel() {
+#ifdef NDEBUG
+    return Level::Off;
+#else
+    return Level::Async;
+#endif
+}
+
+void Diagnostics::setLevel(Level newLevel) {
+    if (level == Level::Async) {
+        // 切换前取出已经收到的消息
+        drain();
+    }
+    if (!GLEW_KHR_debug && !GLEW_VERSION_4_3) {
+        // 没有调试输出时Sync只检查glGetError
+        if (newLevel == Level::Async) {
+            std::cout << "Warning: GL debug output is not supported, GL diagnostics disabled" << std::endl;
+            newLevel = Level::Off;
+        }
+        level = newLevel;
+        return;
+    }
+    level = newLevel;
+    switch (level) {
+        case Level::Off:
+            glDebugMessageCallback(nullptr, nullptr);
+            glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            glDisable(GL_DEBUG_OUTPUT);
+            break;
+        case Level::Async:
+            glEnable(GL_DEBUG_OUTPUT);
+            glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            glDebugMessageCallback(asyncCallback, this);
+            // 通知类消息（缓冲放在哪块显存等）数量多且没有问题，直接在驱动中过滤
+            glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+            glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+            break;
+        case Level::Sync:
+            glEnable(GL_DEBUG_OUTPUT);
+            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            glDebugMessageCallback(syncCallback, this);
+            glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+            break;
+    }
+}
+
+void Diagnostics::print(GLenum source, GLenum type, GLuint id, GLenum severity, const char* message) {
+    std::cerr << "GL CALLBACK: " << (type == GL_DEBUG_TYPE_ERROR ? "** GL ERROR **" : "")
+              << " source = " << source << ", type = " << type << ", id = " << id
+              << ", severity = " << severity << ", message = " << message << std::endl;
+}
+
+void GLAPIENTRY Diagnostics::asyncCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                           GLsizei length, const GLchar* message, const void* userParam) {
+    static_cast<Diagnostics*>(const_cast<void*>(userParam))->push(source, type, id, severity, length, message);
+}
+
+void GLAPIENTRY Diagnostics::syncCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                          GLsizei, const GLchar* message, const void*) {
+    print(source, type, id, severity, message);
+}
+
+void Diagnostics::push(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                       const GLchar* message) {
+    // 有界的多生产者环形缓冲：先用CAS占住位置，写完内容后再发布序号
+    uint64_t position = writePosition.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &ring[position & (RING_SIZE - 1)];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+        if (difference == 0) {
+            if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (difference < 0) {
+            // 缓冲已满：主线程还没有取走，丢弃并计数
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else {
+            position = writePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->source = source;
+    slot->type = type;
+    slot->id = id;
+    slot->severity = severity;
+    size_t size = length >= 0 ? static_cast<size_t>(length) : std::strlen(message);
+    size = std::min(size, MESSAGE_LENGTH - 1);
+    std::memcpy(slot->text, message, size);
+    slot->text[size] = '\0';
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+void Diagnostics::drain() {
+    for (;;) {
+        Slot& slot = ring[readPosition & (RING_SIZE - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != readPosition + 1) {
+            break;
+        }
+        messageCount++;
+        Message& message = messages[messageKey(slot.source, slot.type, slot.id)];
+        if (message.count++ == 0) {
+            message.type = slot.type;
+            message.severity = slot.severity;
+            message.text = slot.text;
+            print(slot.source, slot.type, slot.id, slot.severity, slot.text);
+        }
+        slot.sequence.store(readPosition + RING_SIZE, std::memory_order_release);
+        readPosition++;
+    }
+}
+
+void Diagnostics::checkErrors(const char* label) {
+    GLenum error;
+    while ((error = glGetError()) != GL_NO_ERROR) {
+        messageCount++;
+        std::cerr << "OpenGL error: " << error << " (" << label << ")" << std::endl;
+    }
+}
+
+void Diagnostics::endFrame() {
+    if (level == Level::Async) {
+        drain();
+    }
+    else if (level == Level::Sync) {
+        checkErrors("frame");
+    }
+}
+
+void Diagnostics::warning(const char* message) {
+    if (warnings[message]++ == 0) {
+        std::cerr << "Warning: " << message << std::endl;
+    }
+}
+
+void Diagnostics::printSummary() const {
+    if (messageCount == 0 && warnings.empty() && getDroppedCount() == 0) {
+        return;
+    }
+    if (level == Level::Sync) {
+        // 同步级别的调试消息在回调中已经直接打印，这里只统计glGetError
+        std::cout << "GL diagnostics (sync): " << messageCount << " glGetError errors" << std::endl;
+    }
+    else {
+        std::cout << "GL diagnostics (" << levelName(level) << "): " << messageCount << " messages, "
+                  << messages.size() << " unique, " << getDroppedCount() << " dropped" << std::endl;
+    }
+    // 重复最多的消息排在前面
+    std::vector<const Message*> repeated;
+    for (const auto& entry : messages) {
+        if (entry.second.count > 1) {
+            repeated.push_back(&entry.second);
+        }
+    }
+    std::sort(repeated.begin(), repeated.end(),
+              [](const Message* a, const Message* b) { return a->count > b->count; });
+    for (const Message* message : repeated) {
+        std::cout << "  x" << message->count << "  " << message->text << std::endl;
+    }
+    for (const auto& entry : warnings) {
+        std::cout << "  x" << entry.second << "  Warning: " << entry.first << std::endl;
+    }
+}
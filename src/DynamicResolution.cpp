@@ -0,0 +1,64 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+
+DynamicResolution::DynamicResolution(int maxDivisor, double budgetMs)
+    : level(0), budgetMs(budgetMs), smoothedScene(0.0), smoothedFixed(0.0), settle(SETTLE_FRAMES),
+      hasSample(false), enabled(true), changes(0) {
+    maxDivisor = std::max(1, maxDivisor);
+    for (int divisor = 1; divisor <= maxDivisor; divisor++) {
+        if (maxDivisor % divisor == 0) {
+            divisors.push_back(divisor);
+        }
+    }
+}
+
+void DynamicResolution::setEnabled(bool newEnabled) {
+    enabled = newEnabled;
+    if (!enabled) {
+        setLevel(0);
+    }
+}
+
+void DynamicResolution::setLevel(size_t newLevel) {
+    if (newLevel != level) {
+        level = newLevel;
+        changes++;
+    }
+    // 切换前的计时结果还在查询队列中，丢弃平滑值并等待新分辨率的结果
+    settle = SETTLE_FRAMES;
+    hasSample = false;
+}
+
+bool DynamicResolution::update(double sceneMs, double fixedMs) {
+    if (!enabled || sceneMs < 0.0) {
+        return false;
+    }
+    if (settle > 0) {
+        settle--;
+        return false;
+    }
+    fixedMs = std::max(0.0, fixedMs);
+    if (hasSample) {
+        smoothedScene += (sceneMs - smoothedScene) * SMOOTHING;
+        smoothedFixed += (fixedMs - smoothedFixed) * SMOOTHING;
+    }
+    else {
+        smoothedScene = sceneMs;
+        smoothedFixed = fixedMs;
+        hasSample = true;
+    }
+
+    size_t previous = level;
+    if (getSmoothedMs() > budgetMs && level + 1 < divisors.size()) {
+        setLevel(level + 1);
+    }
+    else if (level > 0) {
+        // 场景像素数按divisor的平方变化
+        double ratio = static_cast<double>(divisors[level]) / divisors[level - 1];
+        double predicted = smoothedScene * ratio * ratio + smoothedFixed;
+        if (predicted < budgetMs * UPSCALE_HEADROOM) {
+            setLevel(level - 1);
+        }
+    }
+    return level != previous;
+}
@@ -0,0 +1,147 @@
+#include "FramePacer.h"
+#include "Profiler.h"
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+FramePacer::FramePacer()
+    : swapMode(SwapMode::VSync), targetFps(0.0), periodNs(0), deadlineNs(0), inputNs(-1),
+      lastLatencyMs(-1.0), nextLatency(0), missedFrames(0) {
+}
+
+int64_t FramePacer::now() {
+    // 与Profiler使用同一个时钟，trace中的区间可以直接对齐
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* FramePacer::swapModeName(SwapMode mode) {
+    switch (mode) {
+        case SwapMode::VSync:
+            return "vsync";
+        case SwapMode::Adaptive:
+            return "adaptive";
+        case SwapMode::Uncapped:
+            return "uncapped";
+        default:
+            return "unknown";
+    }
+}
+
+bool FramePacer::parseSwapMode(const std::string& name, SwapMode& mode) {
+    for (int i = 0; i < static_cast<int>(SwapMode::Count); i++) {
+        if (name == swapModeName(static_cast<SwapMode>(i))) {
+            mode = static_cast<SwapMode>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void FramePacer::setSwapMode(SwapMode mode) {
+    if (mode == SwapMode::Adaptive && !glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+        !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+        std::cout << "Warning: adaptive vsync is not supported, falling back to vsync" << std::endl;
+        mode = SwapMode::VSync;
+    }
+    swapMode = mode;
+    switch (mode) {
+        case SwapMode::VSync:
+            glfwSwapInterval(1);
+            break;
+        case SwapMode::Adaptive:
+            glfwSwapInterval(-1);
+            break;
+        default:
+            glfwSwapInterval(0);
+            break;
+    }
+}
+
+void FramePacer::setTargetFps(double fps) {
+    targetFps = std::max(0.0, fps);
+    periodNs = targetFps > 0.0 ? static_cast<int64_t>(1e9 / targetFps) : 0;
+    deadlineNs = 0;
+}
+
+void FramePacer::reset() {
+    deadlineNs = 0;
+}
+
+void FramePacer::waitForNextFrame() {
+    if (periodNs == 0) {
+        return;
+    }
+    PROFILE_SCOPE("frameLimiter");
+    int64_t current = now();
+    if (deadlineNs == 0 || current > deadlineNs + periodNs) {
+        // 第一帧或者已经落后超过一个周期（如空闲等待之后）：从当前时间重新开始，不补帧
+        if (deadlineNs != 0) {
+            missedFrames++;
+        }
+        deadlineNs = current + periodNs;
+        return;
+    }
+    int64_t sleepNs = deadlineNs - current - SPIN_NS;
+    if (sleepNs > 0) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(sleepNs));
+    }
+    while (now() < deadlineNs) {
+        std::this_thread::yield();
+    }
+    deadlineNs += periodNs;
+}
+
+void FramePacer::markInput() {
+    inputNs = now();
+}
+
+void FramePacer::markSwap() {
+    if (inputNs < 0) {
+        return;
+    }
+    int64_t swapNs = now();
+    PROFILE_RECORD("inputToSwap", inputNs, swapNs);
+    lastLatencyMs = (swapNs - inputNs) / 1e6;
+    inputNs = -1;
+    if (latencies.size() < MAX_HISTORY) {
+        latencies.push_back(lastLatencyMs);
+    }
+    else {
+        latencies[nextLatency] = lastLatencyMs;
+        nextLatency = (nextLatency + 1) % MAX_HISTORY;
+    }
+}
+
+FramePacer::LatencyStats FramePacer::getLatencyStats() const {
+    LatencyStats stats = {latencies.size(), 0.0, 0.0, 0.0, 0.0};
+    if (latencies.empty()) {
+        return stats;
+    }
+    std::vector<double> sorted(latencies);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double ms : sorted) {
+        sum += ms;
+    }
+    stats.minMs = sorted.front();
+    stats.avgMs = sum / sorted.size();
+    stats.p99Ms = sorted[static_cast<size_t>(0.99 * (sorted.size() - 1))];
+    stats.maxMs = sorted.back();
+    return stats;
+}
+
+void FramePacer::printSummary() const {
+    LatencyStats stats = getLatencyStats();
+    std::cout << "Frame pacing: " << swapModeName(swapMode) << ", target "
+              << (targetFps > 0.0 ? std::to_string(static_cast<int>(targetFps)) + " fps" : std::string("uncapped"))
+              << ", " << missedFrames << " missed frames" << std::endl;
+    std::cout << std::fixed << std::setprecision(3)
+              << "  input->swap min " << stats.minMs << " ms  avg " << stats.avgMs << " ms  p99 "
+              << stats.p99Ms << " ms  max " << stats.maxMs << " ms  (" << stats.samples << " samples)"
+              << std::endl;
+}
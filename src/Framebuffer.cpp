@@ -1,7 +1,9 @@
 #include "Framebuffer.h"
+#include "GLState.h"
 #include <iostream>
 
-Framebuffer::Framebuffer(int width, int height) : width(width), height(height) {
+Framebuffer::Framebuffer(int width, int height, MemoryCategory category, GLenum colorFormat, bool depth)
+    : RBO(0), width(width), height(height), category(category), colorFormat(colorFormat), depth(depth) {
     Create();
 }
 
@@ -12,42 +14,56 @@ Framebuffer::~Framebuffer() {
 void Framebuffer::Create() {
     // 生成帧缓冲对象
     glGenFramebuffers(1, &FBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    GLState::get().bindFramebuffer(FBO);
 
     // 生成纹理附件
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+    GLState::get().bindTexture(0, texture);
+    MemoryTracker::get().texImage2D(texture, colorFormat, width, height, GL_RGB, GL_UNSIGNED_BYTE, NULL,
+                                    category, this, "Framebuffer");
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // 后处理读取相邻像素时不绕到对边
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
 
     // 生成渲染缓冲对象
-    glGenRenderbuffers(1, &RBO);
-    glBindRenderbuffer(GL_RENDERBUFFER, RBO);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, RBO);
+    if (depth) {
+        glGenRenderbuffers(1, &RBO);
+        glBindRenderbuffer(GL_RENDERBUFFER, RBO);
+        MemoryTracker::get().renderbufferStorage(RBO, GL_DEPTH24_STENCIL8, width, height,
+                                                 category, this, "Framebuffer");
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, RBO);
+    }
 
     // 检查帧缓冲是否完整
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::get().bindFramebuffer(0);
 }
 
 void Framebuffer::Cleanup() {
+    MemoryTracker::get().release(MemoryTracker::Resource::Texture, texture);
+    if (RBO != 0) {
+        MemoryTracker::get().release(MemoryTracker::Resource::Renderbuffer, RBO);
+        glDeleteRenderbuffers(1, &RBO);
+        RBO = 0;
+    }
+    GLState::get().deleteFramebuffer(FBO);
+    GLState::get().deleteTexture(texture);
     glDeleteFramebuffers(1, &FBO);
     glDeleteTextures(1, &texture);
-    glDeleteRenderbuffers(1, &RBO);
 }
 
 void Framebuffer::Bind() {
-    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    GLState::get().bindFramebuffer(FBO);
 }
 
 void Framebuffer::Unbind() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::get().bindFramebuffer(0);
 }
 
 void Framebuffer::Resize(int newWidth, int newHeight) {
@@ -0,0 +1,206 @@
+#include "GLState.h"
+#include "RenderStats.h"
+
+namespace {
+
+// 状态未知（启动时或invalidate之后），下一次调用一定会发出
+const GLuint UNKNOWN = 0xffffffffu;
+
+}
+
+GLState& GLState::get() {
+    static GLState state;
+    return state;
+}
+
+GLState::GLState() {
+    invalidate();
+}
+
+void GLState::invalidate() {
+    program = UNKNOWN;
+    vertexArray = UNKNOWN;
+    arrayBuffer = UNKNOWN;
+    uniformBuffer = UNKNOWN;
+    for (GLuint& binding : uniformBindings) {
+        binding = UNKNOWN;
+    }
+    framebuffer = UNKNOWN;
+    viewportRect[0] = viewportRect[1] = viewportRect[2] = viewportRect[3] = -1;
+    depthTest = -1;
+    blend = -1;
+    cullFace = -1;
+    depthWrite = -1;
+    blendSource = UNKNOWN;
+    blendDestination = UNKNOWN;
+    activeUnit = UNKNOWN;
+    for (GLuint& texture : textures) {
+        texture = UNKNOWN;
+    }
+}
+
+bool GLState::change(bool changed) {
+    RenderStats& stats = RenderStats::get();
+    if (changed) {
+        stats.stateCalls++;
+    }
+    else {
+        stats.stateCallsAvoided++;
+    }
+    return changed;
+}
+
+void GLState::useProgram(GLuint newProgram) {
+    if (change(program != newProgram)) {
+        glUseProgram(newProgram);
+        program = newProgram;
+    }
+}
+
+void GLState::bindVertexArray(GLuint vao) {
+    if (change(vertexArray != vao)) {
+        glBindVertexArray(vao);
+        vertexArray = vao;
+    }
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    GLuint* cached = target == GL_ARRAY_BUFFER ? &arrayBuffer
+                   : target == GL_UNIFORM_BUFFER ? &uniformBuffer
+                   : nullptr;
+    if (change(!cached || *cached != buffer)) {
+        glBindBuffer(target, buffer);
+        if (cached) {
+            *cached = buffer;
+        }
+    }
+}
+
+void GLState::bindUniformBuffer(GLuint binding, GLuint buffer) {
+    bool cached = binding < MAX_UNIFORM_BINDINGS;
+    if (change(!cached || uniformBindings[binding] != buffer || uniformBuffer != buffer)) {
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+        if (cached) {
+            uniformBindings[binding] = buffer;
+        }
+        uniformBuffer = buffer;
+    }
+}
+
+void GLState::bindFramebuffer(GLuint newFramebuffer) {
+    if (change(framebuffer != newFramebuffer)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, newFramebuffer);
+        framebuffer = newFramebuffer;
+    }
+}
+
+void GLState::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (change(viewportRect[0] != x || viewportRect[1] != y || viewportRect[2] != width ||
+               viewportRect[3] != height)) {
+        glViewport(x, y, width, height);
+        viewportRect[0] = x;
+        viewportRect[1] = y;
+        viewportRect[2] = width;
+        viewportRect[3] = height;
+    }
+}
+
+void GLState::setEnabled(GLenum capability, bool enabled) {
+    int* cached = capability == GL_DEPTH_TEST ? &depthTest
+                : capability == GL_BLEND ? &blend
+                : capability == GL_CULL_FACE ? &cullFace
+                : nullptr;
+    int value = enabled ? 1 : 0;
+    if (change(!cached || *cached != value)) {
+        if (enabled) {
+            glEnable(capability);
+        }
+        else {
+            glDisable(capability);
+        }
+        if (cached) {
+            *cached = value;
+        }
+    }
+}
+
+void GLState::depthMask(bool enabled) {
+    int value = enabled ? 1 : 0;
+    if (change(depthWrite != value)) {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+        depthWrite = value;
+    }
+}
+
+void GLState::blendFunc(GLenum source, GLenum destination) {
+    if (change(blendSource != source || blendDestination != destination)) {
+        glBlendFunc(source, destination);
+        blendSource = source;
+        blendDestination = destination;
+    }
+}
+
+void GLState::bindTexture(GLuint unit, GLuint texture, GLenum target) {
+    if (target != GL_TEXTURE_2D) {
+        activeTexture(unit);
+        change(true);
+        glBindTexture(target, texture);
+        return;
+    }
+    if (unit >= MAX_TEXTURE_UNITS) {
+        change(true);
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        activeUnit = unit;
+        return;
+    }
+    if (textures[unit] == texture) {
+        change(false);
+        return;
+    }
+    activeTexture(unit);
+    change(true);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    textures[unit] = texture;
+}
+
+void GLState::activeTexture(GLuint unit) {
+    if (change(activeUnit != unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeUnit = unit;
+    }
+}
+
+void GLState::deleteVertexArray(GLuint vao) {
+    if (vertexArray == vao) {
+        vertexArray = 0;
+    }
+}
+
+void GLState::deleteBuffer(GLuint buffer) {
+    if (arrayBuffer == buffer) {
+        arrayBuffer = 0;
+    }
+    if (uniformBuffer == buffer) {
+        uniformBuffer = 0;
+    }
+    for (GLuint& binding : uniformBindings) {
+        if (binding == buffer) {
+            binding = 0;
+        }
+    }
+}
+
+void GLState::deleteFramebuffer(GLuint deleted) {
+    if (framebuffer == deleted) {
+        framebuffer = 0;
+    }
+}
+
+void GLState::deleteTexture(GLuint texture) {
+    for (GLuint& bound : textures) {
+        if (bound == texture) {
+            bound = 0;
+        }
+    }
+}
@@ -0,0 +1,328 @@
+#include "GpuProfiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+int64_t cpuNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 重新校准GPU时钟偏移的间隔（帧）
+const uint64_t CALIBRATION_INTERVAL = 600;
+
+}
+
+GpuProfiler::GpuProfiler() : GpuProfiler(detectMode()) {
+}
+
+GpuProfiler::GpuProfiler(Mode mode)
+    : mode(mode), frameIndex(0), droppedFrames(0), activePass(-1), inFrame(false),
+      gpuToCpuOffsetNs(0), passStartNs(0) {
+    for (int i = 0; i < FRAME_LATENCY; i++) {
+        slots[i].frameIndex = 0;
+    }
+    calibrate();
+}
+
+GpuProfiler::~GpuProfiler() {
+    for (FrameSlot& slot : slots) {
+        recycleQueries(slot);
+        if (!slot.freeElapsed.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(slot.freeElapsed.size()), slot.freeElapsed.data());
+        }
+        if (!slot.freeTimestamps.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(slot.freeTimestamps.size()), slot.freeTimestamps.data());
+        }
+    }
+}
+
+GpuProfiler::Mode GpuProfiler::detectMode() {
+    const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    if (renderer != nullptr) {
+        std::string name(renderer);
+        if (name.find("llvmpipe") != std::string::npos ||
+            name.find("softpipe") != std::string::npos ||
+            name.find("SwiftShader") != std::string::npos) {
+            return Mode::FinishFence;
+        }
+    }
+    return Mode::TimerQuery;
+}
+
+void GpuProfiler::calibrate() {
+    // 同一时刻读取GPU和CPU时间，得到两条时间轴的偏移
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    gpuToCpuOffsetNs = cpuNowNs() - static_cast<int64_t>(gpuNow);
+}
+
+void GpuProfiler::beginFrame() {
+    if (inFrame) {
+        endFrame();
+    }
+    // 复用FRAME_LATENCY帧之前的槽位，先把它的结果取回
+    FrameSlot& slot = slots[frameIndex % FRAME_LATENCY];
+    collect(slot);
+    slot.frameIndex = frameIndex;
+
+    if (frameIndex % CALIBRATION_INTERVAL == 0) {
+        calibrate();
+    }
+    inFrame = true;
+}
+
+void GpuProfiler::endFrame() {
+    if (!inFrame) {
+        return;
+    }
+    if (activePass >= 0) {
+        endPass();
+    }
+    inFrame = false;
+    frameIndex++;
+}
+
+void GpuProfiler::flush() {
+    endFrame();
+    glFinish();
+    for (int i = 0; i < FRAME_LATENCY; i++) {
+        collect(slots[(frameIndex + i) % FRAME_LATENCY]);
+    }
+}
+
+void GpuProfiler::beginPass(const char* name) {
+    if (!inFrame) {
+        return;
+    }
+    if (activePass >= 0) {
+        // GL_TIME_ELAPSED查询不能嵌套
+        std::cerr << "Warning: GPU pass '" << name << "' started while '"
+                  << passes[activePass].name << "' is still active" << std::endl;
+        return;
+    }
+
+    if (mode == Mode::FinishFence) {
+        glFinish();
+        passStartNs = cpuNowNs();
+        activePass = findOrAddPass(name);
+        return;
+    }
+
+    FrameSlot& slot = slots[frameIndex % FRAME_LATENCY];
+    PendingQuery query;
+    query.pass = findOrAddPass(name);
+    query.beginQuery = acquireQuery(slot.freeTimestamps);
+    query.elapsedQuery = acquireQuery(slot.freeElapsed);
+    query.endQuery = acquireQuery(slot.freeTimestamps);
+
+    glQueryCounter(query.beginQuery, GL_TIMESTAMP);
+    glBeginQuery(GL_TIME_ELAPSED, query.elapsedQuery);
+    slot.queries.push_back(query);
+    activePass = query.pass;
+}
+
+void GpuProfiler::endPass() {
+    if (activePass < 0) {
+        return;
+    }
+    if (mode == Mode::FinishFence) {
+        glFinish();
+        int64_t endNs = cpuNowNs();
+        record(activePass, frameIndex, passStartNs, static_cast<uint64_t>(endNs - passStartNs));
+        activePass = -1;
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    glQueryCounter(slots[frameIndex % FRAME_LATENCY].queries.back().endQuery, GL_TIMESTAMP);
+    activePass = -1;
+}
+
+int GpuProfiler::findOrAddPass(const char* name) {
+    for (size_t i = 0; i < passes.size(); i++) {
+        if (passes[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    PassHistory history;
+    history.name = name;
+    history.next = 0;
+    history.total = 0;
+    history.lastMs = -1.0;
+    passes.push_back(history);
+    return static_cast<int>(passes.size() - 1);
+}
+
+unsigned int GpuProfiler::acquireQuery(std::vector<unsigned int>& freeList) {
+    if (freeList.empty()) {
+        unsigned int query = 0;
+        glGenQueries(1, &query);
+        return query;
+    }
+    unsigned int query = freeList.back();
+    freeList.pop_back();
+    return query;
+}
+
+void GpuProfiler::recycleQueries(FrameSlot& slot) {
+    for (const PendingQuery& query : slot.queries) {
+        slot.freeElapsed.push_back(query.elapsedQuery);
+        slot.freeTimestamps.push_back(query.beginQuery);
+        slot.freeTimestamps.push_back(query.endQuery);
+    }
+    slot.queries.clear();
+}
+
+void GpuProfiler::collect(FrameSlot& slot) {
+    if (slot.queries.empty()) {
+        return;
+    }
+
+    // 查询按提交顺序完成，最后一个可用说明整帧都可用；否则丢弃这一帧而不是等待
+    GLint available = 0;
+    glGetQueryObjectiv(slot.queries.back().endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (!available) {
+        droppedFrames++;
+    }
+    else {
+        for (const PendingQuery& query : slot.queries) {
+            GLuint64 elapsed = 0;
+            GLuint64 beginTime = 0;
+            GLuint64 endTime = 0;
+            glGetQueryObjectui64v(query.elapsedQuery, GL_QUERY_RESULT, &elapsed);
+            glGetQueryObjectui64v(query.beginQuery, GL_QUERY_RESULT, &beginTime);
+            glGetQueryObjectui64v(query.endQuery, GL_QUERY_RESULT, &endTime);
+
+            record(query.pass, slot.frameIndex,
+                   static_cast<int64_t>(beginTime) + gpuToCpuOffsetNs, elapsed);
+        }
+    }
+
+    recycleQueries(slot);
+}
+
+void GpuProfiler::record(int pass, uint64_t frame, int64_t startNs, uint64_t durationNs) {
+    PassHistory& history = passes[pass];
+    double ms = static_cast<double>(durationNs) / 1.0e6;
+    if (history.samples.size() < MAX_HISTORY) {
+        history.samples.push_back(ms);
+    }
+    else {
+        history.samples[history.next] = ms;
+    }
+    history.next = (history.next + 1) % MAX_HISTORY;
+    history.total++;
+    history.lastMs = ms;
+
+    if (traceEvents.size() < MAX_TRACE_EVENTS) {
+        TraceEvent event;
+        event.pass = pass;
+        event.frameIndex = frame;
+        event.startNs = startNs;
+        event.durationNs = durationNs;
+        traceEvents.push_back(event);
+    }
+}
+
+std::vector<GpuProfiler::PassStats> GpuProfiler::getStats() const {
+    std::vector<PassStats> result;
+    for (const PassHistory& history : passes) {
+        PassStats stats;
+        stats.name = history.name;
+        stats.samples = history.samples.size();
+        stats.minMs = 0.0;
+        stats.avgMs = 0.0;
+        stats.p99Ms = 0.0;
+        stats.lastMs = history.lastMs;
+
+        if (!history.samples.empty()) {
+            std::vector<double> sorted = history.samples;
+            std::sort(sorted.begin(), sorted.end());
+            double sum = 0.0;
+            for (double v : sorted) {
+                sum += v;
+            }
+            size_t p99Index = std::min(sorted.size() - 1, (sorted.size() * 99) / 100);
+            stats.minMs = sorted.front();
+            stats.avgMs = sum / static_cast<double>(sorted.size());
+            stats.p99Ms = sorted[p99Index];
+        }
+        result.push_back(stats);
+    }
+    return result;
+}
+
+double GpuProfiler::getLastMs(const char* name) const {
+    for (const PassHistory& history : passes) {
+        if (history.name == name) {
+            return history.lastMs;
+        }
+    }
+    return -1.0;
+}
+
+std::vector<double> GpuProfiler::getSamples(const char* name) const {
+    for (const PassHistory& history : passes) {
+        if (history.name == name) {
+            return history.samples;
+        }
+    }
+    return std::vector<double>();
+}
+
+void GpuProfiler::printSummary() const {
+    std::cout << "GPU profile (" << frameIndex << " frames, " << droppedFrames << " dropped, "
+              << (mode == Mode::TimerQuery ? "timer queries" : "glFinish fences") << "):" << std::endl;
+    for (const PassStats& stats : getStats()) {
+        std::cout << "  " << std::left << std::setw(12) << stats.name << std::right << std::fixed
+                  << std::setprecision(3)
+                  << " min " << stats.minMs << " ms"
+                  << "  avg " << stats.avgMs << " ms"
+                  << "  p99 " << stats.p99Ms << " ms"
+                  << "  (" << stats.samples << " samples)" << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+bool GpuProfiler::exportCsv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "ERROR::GPU_PROFILER::CANNOT_WRITE " << path << std::endl;
+        return false;
+    }
+    file << "pass,samples,min_ms,avg_ms,p99_ms,last_ms\n";
+    file << std::fixed << std::setprecision(4);
+    for (const PassStats& stats : getStats()) {
+        file << stats.name << ',' << stats.samples << ',' << stats.minMs << ','
+             << stats.avgMs << ',' << stats.p99Ms << ',' << stats.lastMs << '\n';
+    }
+    return true;
+}
+
+bool GpuProfiler::exportTrace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "ERROR::GPU_PROFILER::CANNOT_WRITE " << path << std::endl;
+        return false;
+    }
+
+    // Chrome trace-event格式，时间单位为微秒；GPU事件放在单独的线程轨道上
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":1000,\"args\":{\"name\":\"GPU\"}}";
+    file << std::fixed << std::setprecision(3);
+    for (const TraceEvent& event : traceEvents) {
+        file << ",\n{\"name\":\"" << passes[event.pass].name << "\",\"cat\":\"gpu\",\"ph\":\"X\""
+             << ",\"pid\":0,\"tid\":1000"
+             << ",\"ts\":" << static_cast<double>(event.startNs) / 1000.0
+             << ",\"dur\":" << static_cast<double>(event.durationNs) / 1000.0
+             << ",\"args\":{\"frame\":" << event.frameIndex << "}}";
+    }
+    file << "\n]}\n";
+    return true;
+}
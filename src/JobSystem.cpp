@@ -0,0 +1,86 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+
+JobSystem::JobSystem(unsigned threads)
+    : task(nullptr), count(0), grain(1), next(0), pending(0), generation(0), stopping(false) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 1; i < threads; i++) {
+        workers.emplace_back(&JobSystem::workerLoop, this);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+JobSystem& JobSystem::get() {
+    static JobSystem system;
+    return system;
+}
+
+void JobSystem::parallelFor(size_t itemCount, size_t itemGrain, const std::function<void(size_t, size_t)>& body) {
+    itemGrain = std::max<size_t>(1, itemGrain);
+    if (workers.empty() || itemCount <= itemGrain) {
+        if (itemCount > 0) {
+            body(0, itemCount);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &body;
+        count = itemCount;
+        grain = itemGrain;
+        next = 0;
+        pending = static_cast<unsigned>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+
+    runChunks();
+
+    // 等所有工作线程离开本轮任务，之后task才能失效
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this]() { return pending == 0; });
+    task = nullptr;
+}
+
+void JobSystem::runChunks() {
+    for (size_t begin = next.fetch_add(grain); begin < count; begin = next.fetch_add(grain)) {
+        (*task)(begin, std::min(begin + grain, count));
+    }
+}
+
+void JobSystem::workerLoop() {
+    PROFILE_THREAD_NAME("job worker");
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        runChunks();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+            finished.notify_one();
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#include "MaterialTable.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
+#include "GLState.h"
+#include <GL/glew.h>
+#include <iostream>
+
+namespace {
+
+// std140中的材质：vec3按vec4对齐，高光锐度放在specular的w分量
+struct GpuMaterial {
+    float ambient[4];
+    float diffuse[4];
+    float specular[4];
+};
+
+static_assert(sizeof(GpuMaterial) == 48, "GpuMaterial must match the std140 layout in fragment.glsl");
+
+}
+
+MaterialTable::MaterialTable() : UBO(0), dirty(true) {
+}
+
+MaterialTable::~MaterialTable() {
+    if (UBO != 0) {
+        MemoryTracker::get().release(MemoryTracker::Resource::Buffer, UBO);
+        GLState::get().deleteBuffer(UBO);
+        glDeleteBuffers(1, &UBO);
+    }
+}
+
+unsigned int MaterialTable::add(const Material& material) {
+    if (materials.size() >= MAX_MATERIALS) {
+        std::cerr << "Warning: Material table is full (" << MAX_MATERIALS << "), using material 0" << std::endl;
+        return 0;
+    }
+    materials.push_back(material);
+    dirty = true;
+    return static_cast<unsigned int>(materials.size() - 1);
+}
+
+void MaterialTable::set(unsigned int index, const Material& material) {
+    materials[index] = material;
+    dirty = true;
+}
+
+void MaterialTable::bind() {
+    if (UBO == 0) {
+        // 按最大材质数分配一次
+        glGenBuffers(1, &UBO);
+        GLState::get().bindBuffer(GL_UNIFORM_BUFFER, UBO);
+        MemoryTracker::get().bufferData(GL_UNIFORM_BUFFER, UBO, MAX_MATERIALS * sizeof(GpuMaterial), nullptr,
+                                        GL_DYNAMIC_DRAW, MemoryCategory::Uniform, this, "MaterialTable");
+    }
+    if (dirty && !materials.empty()) {
+        std::vector<GpuMaterial> data(materials.size());
+        for (size_t i = 0; i < materials.size(); i++) {
+            const Material& material = materials[i];
+            for (int c = 0; c < 3; c++) {
+                data[i].ambient[c] = material.ambient[c];
+                data[i].diffuse[c] = material.diffuse[c];
+                data[i].specular[c] = material.specular[c];
+            }
+            data[i].ambient[3] = 0.0f;
+            data[i].diffuse[3] = 0.0f;
+            data[i].specular[3] = material.shininess;
+        }
+        GLState::get().bindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, data.size() * sizeof(GpuMaterial), data.data());
+        RenderStats::get().uploadedBytes += data.size() * sizeof(GpuMaterial);
+    }
+    dirty = false;
+    GLState::get().bindUniformBuffer(BINDING, UBO);
+}
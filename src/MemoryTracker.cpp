@@ -0,0 +1,220 @@
+#include "MemoryTracker.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+const int CATEGORY_COUNT = static_cast<int>(MemoryCategory::Count);
+
+std::string formatBytes(size_t bytes) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (bytes >= 1024 * 1024) {
+        out << bytes / (1024.0 * 1024.0) << " MB";
+    }
+    else {
+        out << bytes / 1024.0 << " KB";
+    }
+    return out.str();
+}
+
+}
+
+MemoryTracker& MemoryTracker::get() {
+    static MemoryTracker tracker;
+    return tracker;
+}
+
+void MemoryTracker::record(Resource resource, uint64_t name, MemoryCategory category,
+                           const void* owner, const char* label, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Key key(static_cast<int>(resource), name);
+    releaseLocked(key);
+
+    allocations[key] = Allocation{category, owner, label != nullptr ? label : "", bytes};
+    CategoryStats& stats = categories[static_cast<int>(category)];
+    stats.liveBytes += bytes;
+    stats.peakBytes = std::max(stats.peakBytes, stats.liveBytes);
+    stats.liveAllocations++;
+    stats.totalAllocations++;
+    liveBytes += bytes;
+    peakBytes = std::max(peakBytes, liveBytes);
+}
+
+void MemoryTracker::release(Resource resource, uint64_t name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    releaseLocked(Key(static_cast<int>(resource), name));
+}
+
+void MemoryTracker::releaseLocked(const Key& key) {
+    auto it = allocations.find(key);
+    if (it == allocations.end()) {
+        return;
+    }
+    CategoryStats& stats = categories[static_cast<int>(it->second.category)];
+    stats.liveBytes -= it->second.bytes;
+    stats.liveAllocations--;
+    liveBytes -= it->second.bytes;
+    allocations.erase(it);
+}
+
+void MemoryTracker::transfer(Resource resource, uint64_t name, const void* newOwner) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = allocations.find(Key(static_cast<int>(resource), name));
+    if (it != allocations.end()) {
+        it->second.owner = newOwner;
+    }
+}
+
+void MemoryTracker::bufferData(GLenum target, GLuint buffer, size_t size, const void* data, GLenum usage,
+                               MemoryCategory category, const void* owner, const char* label) {
+    glBufferData(target, static_cast<GLsizeiptr>(size), data, usage);
+    record(Resource::Buffer, buffer, category, owner, label, size);
+}
+
+void MemoryTracker::texImage2D(GLuint texture, GLint internalFormat, int width, int height, GLenum format,
+                               GLenum type, const void* pixels, MemoryCategory category,
+                               const void* owner, const char* label) {
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, pixels);
+    size_t bytes = static_cast<size_t>(width) * static_cast<size_t>(height) *
+                   bytesPerPixel(static_cast<GLenum>(internalFormat));
+    record(Resource::Texture, texture, category, owner, label, bytes);
+}
+
+void MemoryTracker::texImage3D(GLuint texture, GLint internalFormat, int width, int height, int depth,
+                               GLenum format, GLenum type, const void* pixels, MemoryCategory category,
+                               const void* owner, const char* label) {
+    glTexImage3D(GL_TEXTURE_3D, 0, internalFormat, width, height, depth, 0, format, type, pixels);
+    size_t bytes = static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(depth) *
+                   bytesPerPixel(static_cast<GLenum>(internalFormat));
+    record(Resource::Texture, texture, category, owner, label, bytes);
+}
+
+void MemoryTracker::renderbufferStorage(GLuint renderbuffer, GLenum internalFormat, int width, int height,
+                                        MemoryCategory category, const void* owner, const char* label) {
+    glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, width, height);
+    size_t bytes = static_cast<size_t>(width) * static_cast<size_t>(height) * bytesPerPixel(internalFormat);
+    record(Resource::Renderbuffer, renderbuffer, category, owner, label, bytes);
+}
+
+MemoryTracker::CategoryStats MemoryTracker::getStats(MemoryCategory category) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return categories[static_cast<int>(category)];
+}
+
+size_t MemoryTracker::getLiveBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return liveBytes;
+}
+
+size_t MemoryTracker::getPeakBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return peakBytes;
+}
+
+std::vector<MemoryTracker::OwnerUsage> MemoryTracker::getOwners() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<const void*, size_t> index;
+    std::vector<OwnerUsage> owners;
+    for (const auto& entry : allocations) {
+        const Allocation& allocation = entry.second;
+        auto it = index.find(allocation.owner);
+        if (it == index.end()) {
+            index[allocation.owner] = owners.size();
+            owners.push_back(OwnerUsage{allocation.owner, allocation.label, allocation.bytes});
+        }
+        else {
+            owners[it->second].bytes += allocation.bytes;
+        }
+    }
+    std::sort(owners.begin(), owners.end(), [](const OwnerUsage& a, const OwnerUsage& b) {
+        return a.bytes > b.bytes;
+    });
+    return owners;
+}
+
+void MemoryTracker::update(double nowSeconds) {
+    if (logInterval <= 0.0) {
+        return;
+    }
+    if (lastLogTime < 0.0) {
+        lastLogTime = nowSeconds;
+        return;
+    }
+    if (nowSeconds - lastLogTime >= logInterval) {
+        lastLogTime = nowSeconds;
+        std::cout << logLine() << std::endl;
+    }
+}
+
+std::string MemoryTracker::logLine() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+    out << "[memory] live " << formatBytes(liveBytes) << " (peak " << formatBytes(peakBytes) << ")";
+    for (int i = 0; i < CATEGORY_COUNT; i++) {
+        out << " | " << categoryName(static_cast<MemoryCategory>(i)) << " " << formatBytes(categories[i].liveBytes);
+    }
+    return out.str();
+}
+
+void MemoryTracker::printSummary(size_t topOwners) const {
+    std::cout << "Memory usage:" << std::endl;
+    std::cout << std::left << std::setw(14) << "category" << std::right
+              << std::setw(12) << "live" << std::setw(12) << "peak"
+              << std::setw(8) << "count" << std::setw(10) << "allocs" << std::endl;
+    for (int i = 0; i < CATEGORY_COUNT; i++) {
+        CategoryStats stats = getStats(static_cast<MemoryCategory>(i));
+        std::cout << std::left << std::setw(14) << categoryName(static_cast<MemoryCategory>(i)) << std::right
+                  << std::setw(12) << formatBytes(stats.liveBytes) << std::setw(12) << formatBytes(stats.peakBytes)
+                  << std::setw(8) << stats.liveAllocations << std::setw(10) << stats.totalAllocations << std::endl;
+    }
+    std::cout << "total live " << formatBytes(getLiveBytes()) << ", peak " << formatBytes(getPeakBytes()) << std::endl;
+
+    std::vector<OwnerUsage> owners = getOwners();
+    for (size_t i = 0; i < owners.size() && i < topOwners; i++) {
+        std::cout << "  " << owners[i].label << " " << owners[i].owner << ": "
+                  << formatBytes(owners[i].bytes) << std::endl;
+    }
+}
+
+const char* MemoryTracker::categoryName(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::Mesh: return "mesh";
+        case MemoryCategory::RenderTarget: return "render_target";
+        case MemoryCategory::Shadow: return "shadow";
+        case MemoryCategory::Capture: return "capture";
+        case MemoryCategory::CpuMesh: return "cpu_mesh";
+        case MemoryCategory::Uniform: return "uniform";
+        case MemoryCategory::Palette: return "palette";
+        default: return "unknown";
+    }
+}
+
+size_t MemoryTracker::bytesPerPixel(GLenum internalFormat) {
+    switch (internalFormat) {
+        case GL_RED:
+        case GL_R8:
+        case GL_R8UI:
+            return 1;
+        case GL_RG:
+        case GL_RG8:
+        case GL_R16F:
+        case GL_DEPTH_COMPONENT16:
+            return 2;
+        case GL_RGBA16F:
+        case GL_RGB16F:
+        case GL_RG32F:
+            return 8;
+        case GL_RGBA32F:
+        case GL_RGB32F:
+            return 16;
+        case GL_DEPTH32F_STENCIL8:
+            return 8;
+        // GL_RGB/RGB8/RGBA/RGBA8/DEPTH24_STENCIL8/DEPTH_COMPONENT24/32F等
+        default:
+            return 4;
+    }
+}
@@ -0,0 +1,237 @@
+#include "MeshCache.h"
+#include "Profiler.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <process.h>
+#endif
+
+static_assert(sizeof(MeshCache::Header) == 72, "cache header layout changed, bump FORMAT_VERSION");
+static_assert(sizeof(Vertex) == 28, "vertex layout changed, bump FORMAT_VERSION");
+
+MeshCache* MeshCache::defaultCache = nullptr;
+
+namespace {
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+}
+
+MeshCache::MeshCache(const std::string& directory) : directory(directory) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Warning: cannot create mesh cache directory " << directory << ": " << error.message() << std::endl;
+    }
+}
+
+std::string MeshCache::pathFor(uint64_t key) const {
+    std::ostringstream name;
+    name << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".mesh";
+    return name.str();
+}
+
+std::string MeshCache::temporaryPath(const std::string& path) {
+    static std::atomic<uint32_t> counter(0);
+#ifndef _WIN32
+    long pid = static_cast<long>(getpid());
+#else
+    long pid = static_cast<long>(_getpid());
+#endif
+    std::ostringstream name;
+    name << path << "." << pid << "." << counter++ << ".tmp";
+    return name.str();
+}
+
+uint64_t MeshCache::hash(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t value = seed;
+    for (size_t i = 0; i < size; i++) {
+        value ^= bytes[i];
+        value *= 1099511628211ull;
+    }
+    return value;
+}
+
+uint64_t MeshCache::hashWords(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    const uint64_t prime1 = 0x9e3779b185ebca87ull;
+    const uint64_t prime2 = 0xc2b2ae3d27d4eb4full;
+    uint64_t value = seed ^ (static_cast<uint64_t>(size) * prime1);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        value = rotateLeft(value ^ (word * prime2), 31) * prime1;
+    }
+    for (; i < size; i++) {
+        value = rotateLeft(value ^ (bytes[i] * prime2), 11) * prime1;
+    }
+    // 最后打散，使每个输入位都影响所有输出位
+    value ^= value >> 33;
+    value *= prime2;
+    value ^= value >> 29;
+    return value;
+}
+
+uint64_t MeshCache::hashSampled(const void* data, size_t size, uint64_t seed) {
+    if (size <= SAMPLE_COUNT * SAMPLE_BYTES) {
+        return hashWords(data, size, seed);
+    }
+    // 第一段从开头、最后一段到结尾，其余等间距分布
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    size_t step = (size - SAMPLE_BYTES) / (SAMPLE_COUNT - 1);
+    uint64_t value = hash(&size, sizeof(size), seed);
+    for (size_t i = 0; i < SAMPLE_COUNT; i++) {
+        size_t offset = i + 1 < SAMPLE_COUNT ? i * step : size - SAMPLE_BYTES;
+        value = hashWords(bytes + offset, SAMPLE_BYTES, value);
+    }
+    return value;
+}
+
+uint64_t MeshCache::keyFor(const Box* boxes, size_t count) {
+    uint32_t versions[3] = {FORMAT_VERSION, MESHER_VERSION, static_cast<uint32_t>(sizeof(Vertex))};
+    uint64_t key = hash(versions, sizeof(versions));
+    return hash(boxes, count * sizeof(Box), key);
+}
+
+bool MeshCache::load(uint64_t key, Model& model) const {
+    PROFILE_FUNCTION();
+    std::string path = pathFor(key);
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    const unsigned char* data = static_cast<const unsigned char*>(mapping);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<unsigned char> fileData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    size_t size = fileData.size();
+    const unsigned char* data = fileData.data();
+#endif
+
+    Header header;
+    bool valid = size >= sizeof(Header);
+    if (valid) {
+        std::memcpy(&header, data, sizeof(Header));
+        valid = header.magic == MAGIC &&
+                header.formatVersion == FORMAT_VERSION &&
+                header.mesherVersion == MESHER_VERSION &&
+                header.vertexStride == sizeof(Vertex) &&
+                header.key == key &&
+                header.vertexCount > 0 &&
+                header.vertexOffset % BLOB_ALIGNMENT == 0 &&
+                header.vertexOffset <= size &&
+                header.vertexCount <= (size - header.vertexOffset) / sizeof(Vertex);
+    }
+    if (valid) {
+        const Vertex* source = reinterpret_cast<const Vertex*>(data + header.vertexOffset);
+        size_t count = static_cast<size_t>(header.vertexCount);
+        glm::vec3 meshMin(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+        glm::vec3 meshMax(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+        if (model.residency == Model::Residency::CpuAndGpu) {
+            // 需要CPU副本时整块拷贝一次
+            model.vertices.assign(source, source + count);
+            source = model.vertices.data();
+        }
+        // 否则映射区直接作为上传源
+        model.uploadMesh(source, count, meshMin, meshMax);
+    }
+    else {
+        std::cerr << "Warning: ignoring stale or corrupt mesh cache " << path << std::endl;
+    }
+
+#ifndef _WIN32
+    munmap(mapping, size);
+#endif
+    return valid;
+}
+
+bool MeshCache::store(uint64_t key, const Vertex* vertices, size_t count,
+                      const glm::vec3& boundsMin, const glm::vec3& boundsMax) const {
+    PROFILE_FUNCTION();
+    if (count == 0) {
+        return false;
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.formatVersion = FORMAT_VERSION;
+    header.mesherVersion = MESHER_VERSION;
+    header.vertexStride = sizeof(Vertex);
+    header.key = key;
+    header.vertexCount = count;
+    header.vertexOffset = alignUp(sizeof(Header), BLOB_ALIGNMENT);
+    header.indexCount = 0;
+    header.indexOffset = 0;
+    for (int i = 0; i < 3; i++) {
+        header.boundsMin[i] = boundsMin[i];
+        header.boundsMax[i] = boundsMax[i];
+    }
+
+    std::string path = pathFor(key);
+    std::string temporary = temporaryPath(path);
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Warning: cannot write mesh cache " << temporary << std::endl;
+            return false;
+        }
+        char padding[BLOB_ALIGNMENT] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(padding, static_cast<std::streamsize>(header.vertexOffset - sizeof(header)));
+        file.write(reinterpret_cast<const char*>(vertices), static_cast<std::streamsize>(count * sizeof(Vertex)));
+        if (!file) {
+            std::cerr << "Warning: failed to write mesh cache " << temporary << std::endl;
+            file.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
@@ -1,512 +1,353 @@
 #include "Model.h"
+#include "ModelBuilder.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "GLState.h"
+#include "Diagnostics.h"
+#include "BuiltinModels.h"
 #include <GL/glew.h>
 #include <iostream>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-Model::Model() : VAO(0), VBO(0) {
+Model::Residency Model::defaultResidency = Model::Residency::CpuAndGpu;
+
+static_assert(sizeof(BuiltinModels::BakedVertex) == sizeof(Vertex) &&
+              offsetof(Vertex, Normal) == offsetof(BuiltinModels::BakedVertex, normal) &&
+              offsetof(Vertex, Color) == offsetof(BuiltinModels::BakedVertex, color) &&
+              offsetof(Vertex, Part) == offsetof(BuiltinModels::BakedVertex, part) &&
+              offsetof(Vertex, Material) == offsetof(BuiltinModels::BakedVertex, material),
+              "baked vertex layout must match Vertex");
+
+namespace {
+
+// 按位置和缩放把方块定义变成方块
+Box catBox(const BuiltinModels::BoxDef& def, const glm::vec3& position, float scale) {
+    return Box{position + glm::vec3(scale * def.offset[0], scale * def.offset[1], scale * def.offset[2]),
+               glm::vec3(scale * def.size[0], scale * def.size[1], scale * def.size[2]),
+               static_cast<unsigned int>(def.color),
+               static_cast<unsigned int>(def.part)};
+}
+
+}
+
+Model::Model()
+    : VAO(0), VBO(0), vertexCount(0), boundsMin(0.0f), boundsMax(0.0f),
+      residency(Residency::CpuAndGpu), sourceGeneratorBytes(0) {
 }
 
 Model::~Model() {
+    destroyBuffers();
+    MemoryTracker::get().release(MemoryTracker::Resource::Cpu, reinterpret_cast<uintptr_t>(this));
+}
+
+Model::Model(Model&& other) noexcept
+    : vertices(std::move(other.vertices)), palette(std::move(other.palette)), VAO(other.VAO), VBO(other.VBO),
+      vertexCount(other.vertexCount), boundsMin(other.boundsMin), boundsMax(other.boundsMax),
+      residency(other.residency), sourceBoxes(std::move(other.sourceBoxes)),
+      sourceGenerator(std::move(other.sourceGenerator)), sourceGeneratorBytes(other.sourceGeneratorBytes) {
+    other.sourceGenerator = nullptr;
+    other.sourceGeneratorBytes = 0;
+    other.VAO = 0;
+    other.VBO = 0;
+    other.vertexCount = 0;
+    MemoryTracker::get().transfer(MemoryTracker::Resource::Buffer, VBO, this);
+    other.trackCpuMemory();
+    trackCpuMemory();
+}
+
+Model& Model::operator=(Model&& other) noexcept {
+    if (this != &other) {
+        destroyBuffers();
+        vertices = std::move(other.vertices);
+        palette = std::move(other.palette);
+        VAO = other.VAO;
+        VBO = other.VBO;
+        vertexCount = other.vertexCount;
+        boundsMin = other.boundsMin;
+        boundsMax = other.boundsMax;
+        residency = other.residency;
+        sourceBoxes = std::move(other.sourceBoxes);
+        sourceGenerator = std::move(other.sourceGenerator);
+        sourceGeneratorBytes = other.sourceGeneratorBytes;
+        other.sourceGenerator = nullptr;
+        other.sourceGeneratorBytes = 0;
+        other.VAO = 0;
+        other.VBO = 0;
+        other.vertexCount = 0;
+        MemoryTracker::get().transfer(MemoryTracker::Resource::Buffer, VBO, this);
+        other.trackCpuMemory();
+        trackCpuMemory();
+    }
+    return *this;
+}
+
+void Model::destroyBuffers() {
     if (VAO != 0) {
+        GLState::get().deleteVertexArray(VAO);
         glDeleteVertexArrays(1, &VAO);
+        VAO = 0;
     }
     if (VBO != 0) {
+        MemoryTracker::get().release(MemoryTracker::Resource::Buffer, VBO);
+        GLState::get().deleteBuffer(VBO);
         glDeleteBuffers(1, &VBO);
+        VBO = 0;
     }
 }
 
-void Model::setupMesh() {
-    if (vertices.empty()) {
-        std::cerr << "Warning: Trying to setup mesh with no vertices" << std::endl;
-        return;
+void Model::createBuffers(size_t count, const Vertex* data) {
+    if (VAO == 0) {
+        glGenVertexArrays(1, &VAO);
+    }
+    if (VBO == 0) {
+        glGenBuffers(1, &VBO);
     }
 
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+    GLState::get().bindVertexArray(VAO);
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, VBO);
+    MemoryTracker::get().bufferData(GL_ARRAY_BUFFER, VBO, count * sizeof(Vertex), data, GL_STATIC_DRAW,
+                                    MemoryCategory::Mesh, this, "Model");
+    RenderStats::get().uploadedBytes += count * sizeof(Vertex);
+    vertexCount = count;
 
     // 顶点位置
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
 
-    // 顶点颜色
+    // 调色板索引（整数属性）
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Color));
+    glVertexAttribIPointer(1, 1, GL_UNSIGNED_BYTE, sizeof(Vertex), (void*)offsetof(Vertex, Color));
 
     // 顶点法线
     glEnableVertexAttribArray(2);
     glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
 
-    glBindVertexArray(0);
+    // 部件索引（整数属性）
+    glEnableVertexAttribArray(3);
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_BYTE, sizeof(Vertex), (void*)offsetof(Vertex, Part));
+
+    // 材质索引（整数属性）
+    glEnableVertexAttribArray(4);
+    glVertexAttribIPointer(4, 1, GL_UNSIGNED_BYTE, sizeof(Vertex), (void*)offsetof(Vertex, Material));
+}
+
+void Model::computeBounds() {
+    if (vertices.empty()) {
+        boundsMin = boundsMax = glm::vec3(0.0f);
+        return;
+    }
+    boundsMin = boundsMax = vertices[0].Position;
+    for (const Vertex& vertex : vertices) {
+        boundsMin = glm::min(boundsMin, vertex.Position);
+        boundsMax = glm::max(boundsMax, vertex.Position);
+    }
+}
+
+void Model::setupMesh() {
+    PROFILE_FUNCTION();
+
+    if (vertices.empty()) {
+        std::cerr << "Warning: Trying to setup mesh with no vertices" << std::endl;
+        return;
+    }
+
+    computeBounds();
+    createBuffers(vertices.size(), vertices.data());
+
+    // 没有源数据时无法重建，只能保留CPU副本
+    if (residency == Residency::GpuOnly && hasSource()) {
+        releaseCpuData();
+    }
+    trackCpuMemory();
+}
+
+void Model::trackCpuMemory() {
+    uintptr_t key = reinterpret_cast<uintptr_t>(this);
+    size_t bytes = cpuMemoryBytes();
+    if (bytes == 0) {
+        MemoryTracker::get().release(MemoryTracker::Resource::Cpu, key);
+    }
+    else {
+        MemoryTracker::get().record(MemoryTracker::Resource::Cpu, key, MemoryCategory::CpuMesh, this, "Model", bytes);
+    }
+}
+
+void Model::uploadMesh(const Vertex* data, size_t count, const glm::vec3& meshMin, const glm::vec3& meshMax) {
+    boundsMin = meshMin;
+    boundsMax = meshMax;
+    createBuffers(count, data);
+    trackCpuMemory();
+}
+
+Vertex* Model::mapMesh(size_t count) {
+    if (count == 0) {
+        return nullptr;
+    }
+    createBuffers(count, nullptr);
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, VBO);
+    void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, count * sizeof(Vertex),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    return static_cast<Vertex*>(mapped);
+}
+
+bool Model::unmapMesh() {
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, VBO);
+    return glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+}
+
+void Model::releaseCpuData() {
+    std::vector<Vertex>().swap(vertices);
+    trackCpuMemory();
+}
+
+const std::vector<Vertex>& Model::ensureCpuData() {
+    if (!vertices.empty()) {
+        return vertices;
+    }
+    if (!sourceBoxes.empty()) {
+        ModelBuilder builder;
+        builder.reserve(sourceBoxes.size());
+        for (const Box& box : sourceBoxes) {
+            builder.addBox(box);
+        }
+        builder.build(vertices);
+        trackCpuMemory();
+    }
+    else if (sourceGenerator) {
+        sourceGenerator(vertices);
+        trackCpuMemory();
+    }
+    else if (vertexCount != 0) {
+        std::cerr << "Warning: GPU-only model has no source data, CPU vertices cannot be rebuilt" << std::endl;
+    }
+    return vertices;
+}
+
+void Model::setSource(const Box* boxes, size_t count) {
+    sourceBoxes.assign(boxes, boxes + count);
+    sourceGenerator = nullptr;
+    sourceGeneratorBytes = 0;
+    trackCpuMemory();
+}
+
+void Model::setSource(SourceGenerator generator, size_t bytes) {
+    std::vector<Box>().swap(sourceBoxes);
+    sourceGenerator = std::move(generator);
+    sourceGeneratorBytes = sourceGenerator ? bytes : 0;
+    trackCpuMemory();
+}
+
+size_t Model::cpuMemoryBytes() const {
+    return vertices.capacity() * sizeof(Vertex) + sourceBoxes.capacity() * sizeof(Box) + sourceGeneratorBytes +
+           palette.capacity() * sizeof(glm::vec3);
+}
+
+size_t Model::gpuMemoryBytes() const {
+    return VBO != 0 ? vertexCount * sizeof(Vertex) : 0;
 }
 
 void Model::draw() const {
-    if (VAO == 0) {
-        std::cerr << "Warning: Trying to draw model before setting up mesh" << std::endl;
+    if (!bindMesh()) {
         return;
     }
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, vertices.size());
-    glBindVertexArray(0);
+    drawBound();
 }
 
-void Model::addCube(const glm::vec3& position, const glm::vec3& size, const glm::vec3& color) {
-    float x = position.x;
-    float y = position.y;
-    float z = position.z;
-    float w = size.x / 2.0f;
-    float h = size.y / 2.0f;
-    float d = size.z / 2.0f;
+bool Model::bindMesh() const {
+    if (VAO == 0) {
+        DIAGNOSTIC_WARNING("Trying to draw model before setting up mesh");
+        return false;
+    }
+    GLState::get().bindVertexArray(VAO);
+    return true;
+}
 
-    // 顶点位置
-    std::vector<glm::vec3> positions = {
-        // 前面 (Z+)
-        {x - w, y - h, z + d}, {x + w, y - h, z + d}, {x + w, y + h, z + d},
-        {x - w, y - h, z + d}, {x + w, y + h, z + d}, {x - w, y + h, z + d},
-        // 后面 (Z-)
-        {x + w, y - h, z - d}, {x - w, y - h, z - d}, {x - w, y + h, z - d},
-        {x + w, y - h, z - d}, {x - w, y + h, z - d}, {x + w, y + h, z - d},
-        // 右面 (X+)
-        {x + w, y - h, z + d}, {x + w, y - h, z - d}, {x + w, y + h, z - d},
-        {x + w, y - h, z + d}, {x + w, y + h, z - d}, {x + w, y + h, z + d},
-        // 左面 (X-)
-        {x - w, y - h, z - d}, {x - w, y - h, z + d}, {x - w, y + h, z + d},
-        {x - w, y - h, z - d}, {x - w, y + h, z + d}, {x - w, y + h, z - d},
-        // 上面 (Y+)
-        {x - w, y + h, z + d}, {x + w, y + h, z + d}, {x + w, y + h, z - d},
-        {x - w, y + h, z + d}, {x + w, y + h, z - d}, {x - w, y + h, z - d},
-        // 下面 (Y-)
-        {x - w, y - h, z - d}, {x + w, y - h, z - d}, {x + w, y - h, z + d},
-        {x - w, y - h, z - d}, {x + w, y - h, z + d}, {x - w, y - h, z + d}
-    };
-
-    // 每个面的法线
-    std::vector<glm::vec3> normals = {
-        // 前面
-        {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f},
-        {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f},
-        // 后面
-        {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f},
-        {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f, -1.0f},
-        // 右面
-        {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f},
-        {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f},
-        // 左面
-        {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
-        {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
-        // 上面
-        {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
-        {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
-        // 下面
-        {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
-        {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}
-    };
-
-    // 添加所有顶点
-    for (size_t i = 0; i < positions.size(); i++) {
-        Vertex vertex;
-        vertex.Position = positions[i];
-        vertex.Color = color;
-        vertex.Normal = normals[i];
-        vertices.push_back(vertex);
+void Model::drawBound() const {
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertexCount));
+    GL_CHECK("Model::drawBound");
+
+    RenderStats& stats = RenderStats::get();
+    stats.drawCalls++;
+    stats.vertices += vertexCount;
+}
+
+unsigned int Model::paletteIndex(std::vector<glm::vec3>& palette, const glm::vec3& color) {
+    for (size_t i = 0; i < palette.size(); i++) {
+        if (palette[i] == color) {
+            return static_cast<unsigned int>(i);
+        }
+    }
+    if (palette.size() >= MAX_PALETTE_COLORS) {
+        std::cerr << "Warning: Palette is full (" << MAX_PALETTE_COLORS << " colors), using color 0" << std::endl;
+        return 0;
+    }
+    palette.push_back(color);
+    return static_cast<unsigned int>(palette.size() - 1);
+}
+
+void Model::addCube(const glm::vec3& position, const glm::vec3& size, const glm::vec3& color) {
+    Box box{position, size, paletteIndex(palette, color)};
+    size_t offset = vertices.size();
+    vertices.resize(offset + ModelBuilder::VERTICES_PER_BOX);
+    ModelBuilder::writeBox(box, &vertices[offset]);
+    if (residency == Residency::GpuOnly) {
+        sourceBoxes.push_back(box);
     }
 }
 
 Model Model::createCube(const glm::vec3& position, const glm::vec3& size, const glm::vec3& color) {
-    Model model;
-    model.addCube(position, size, color);
-    model.setupMesh();
-    return model;
+    ModelBuilder builder;
+    builder.addBox(position, size, color);
+    return builder.finish();
 }
 
 Model Model::createGround(float width, float depth, const glm::vec3& color) {
-    Model model;
-    model.addCube(glm::vec3(0.0f, -0.1f, 0.0f), glm::vec3(width, 0.2f, depth), color);
-    model.setupMesh();
-    return model;
+    PROFILE_FUNCTION();
+    ModelBuilder builder;
+    builder.addBox(glm::vec3(0.0f, -0.1f, 0.0f), glm::vec3(width, 0.2f, depth), color);
+    return builder.finish();
 }
 
 Model Model::createCat(const glm::vec3& position, float scale) {
-    Model model;
-    
-    // 定义颜色
-    glm::vec3 mainColor(0.6f, 0.6f, 0.6f);         // 主体灰色
-    glm::vec3 darkColor(0.1f, 0.1f, 0.1f);         // 深色部分
-    glm::vec3 accentColor(0.7f, 0.7f, 0.7f);       // 强调色
-    glm::vec3 eyeWhite(1.0f, 1.0f, 1.0f);          // 眼睛白色部分
-    glm::vec3 eyeBlack(0.0f, 0.0f, 0.0f);          // 眼睛黑色部分
-    glm::vec3 innerEarColor(1.0f, 0.85f, 0.85f);   // 耳朵内部（粉嫩的肉色）
-    glm::vec3 noseColor(1.0f, 0.6f, 0.7f);         // 鼻子颜色（可爱的粉���）
-    glm::vec3 pawColor(0.85f, 0.75f, 0.7f);        // 爪子颜色（柔和的米色）
-
-    // 身体主体
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.5f, 0.0f),
-        glm::vec3(scale * 0.45f, scale * 0.4f, scale * 0.9f),
-        mainColor
-    );
-    
-    // 身体两侧
-    model.addCube(
-        position + glm::vec3(-scale * 0.2f, scale * 0.5f, 0.0f),
-        glm::vec3(scale * 0.35f, scale * 0.35f, scale * 0.85f),
-        mainColor
-    );
-    model.addCube(
-        position + glm::vec3(scale * 0.2f, scale * 0.5f, 0.0f),
-        glm::vec3(scale * 0.35f, scale * 0.35f, scale * 0.85f),
-        mainColor
-    );
-    
-    // 上部填充
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.65f, 0.0f),
-        glm::vec3(scale * 0.4f, scale * 0.2f, scale * 0.85f),
-        mainColor
-    );
-    
-    // 下部填充
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.3f, 0.0f),
-        glm::vec3(scale * 0.42f, scale * 0.2f, scale * 0.85f),
-        mainColor
-    );
-    
-    // 前后填充
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.5f, scale * 0.4f),
-        glm::vec3(scale * 0.43f, scale * 0.38f, scale * 0.2f),
-        mainColor
-    );
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.5f, -scale * 0.4f),
-        glm::vec3(scale * 0.43f, scale * 0.38f, scale * 0.2f),
-        mainColor
-    );
-    
-    // 角落填充
-    for (float x : {-0.2f, 0.2f}) {
-        for (float z : {-0.35f, 0.35f}) {
-            model.addCube(
-                position + glm::vec3(scale * x, scale * 0.5f, scale * z),
-                glm::vec3(scale * 0.25f, scale * 0.35f, scale * 0.25f),
-                mainColor
-            );
+    PROFILE_FUNCTION();
+    using namespace BuiltinModels;
+
+    // 原点处、单位尺寸的猫直接上传编译期烘焙好的顶点
+    if (position == glm::vec3(0.0f) && scale == 1.0f) {
+        Model model;
+        model.residency = defaultResidency;
+        model.palette = catPalette(CatCoatGray);
+        const Vertex* data = reinterpret_cast<const Vertex*>(CAT_VERTICES.data());
+        if (model.residency == Residency::CpuAndGpu) {
+            model.vertices.resize(CAT_VERTICES.size());
+            std::memcpy(static_cast<void*>(model.vertices.data()), CAT_VERTICES.data(), sizeof(CAT_VERTICES));
+            data = model.vertices.data();
         }
-    }
-    
-    // 腹部
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.4f, 0.0f),
-        glm::vec3(scale * 0.4f, scale * 0.3f, scale * 0.8f),
-        accentColor
-    );
-    
-    // 腹部填充
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.35f, 0.0f),
-        glm::vec3(scale * 0.38f, scale * 0.25f, scale * 0.75f),
-        accentColor
-    );
-    
-    // 腹部边缘填充
-    for (float x : {-0.15f, 0.15f}) {
-        model.addCube(
-            position + glm::vec3(scale * x, scale * 0.38f, 0.0f),
-            glm::vec3(scale * 0.2f, scale * 0.28f, scale * 0.7f),
-            accentColor
-        );
-    }
-    
-    // 身体与腿部的连接
-    for (float x : {-0.2f, 0.2f}) {
-        for (float z : {-0.2f, 0.2f}) {
-            model.addCube(
-                position + glm::vec3(scale * x, scale * 0.3f, scale * z),
-                glm::vec3(scale * 0.25f, scale * 0.2f, scale * 0.25f),
-                mainColor
-            );
+        else {
+            Box boxes[CAT_BOX_COUNT];
+            for (size_t i = 0; i < CAT_BOX_COUNT; i++) {
+                boxes[i] = catBox(CAT_BOXES[i], position, scale);
+            }
+            model.setSource(boxes, CAT_BOX_COUNT);
         }
+        model.uploadMesh(data, CAT_VERTICES.size(),
+                         glm::vec3(CAT_BOUNDS[0][0], CAT_BOUNDS[0][1], CAT_BOUNDS[0][2]),
+                         glm::vec3(CAT_BOUNDS[1][0], CAT_BOUNDS[1][1], CAT_BOUNDS[1][2]));
+        return model;
     }
-    
-    // 头部
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.8f, scale * 0.5f),
-        glm::vec3(scale * 0.4f, scale * 0.35f, scale * 0.4f),
-        mainColor
-    );
-    
-    // 面部前突
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.8f, scale * 0.7f),
-        glm::vec3(scale * 0.35f, scale * 0.3f, scale * 0.25f),
-        mainColor
-    );
-    
-    // 面部轮廓
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.85f, scale * 0.8f),
-        glm::vec3(scale * 0.3f, scale * 0.25f, scale * 0.15f),
-        mainColor
-    );
-    
-    // 鼻子
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.82f, scale * 0.88f),
-        glm::vec3(scale * 0.12f, scale * 0.12f, scale * 0.08f),
-        noseColor
-    );
-    
-    // 眼睛部分
-    // 左眼白色底色
-    model.addCube(
-        position + glm::vec3(-scale * 0.15f, scale * 0.9f, scale * 0.75f),
-        glm::vec3(scale * 0.12f, scale * 0.15f, scale * 0.12f),
-        eyeWhite
-    );
-    // 右眼白色底色
-    model.addCube(
-        position + glm::vec3(scale * 0.15f, scale * 0.9f, scale * 0.75f),
-        glm::vec3(scale * 0.12f, scale * 0.15f, scale * 0.12f),
-        eyeWhite
-    );
-
-    // 左眼黑色瞳孔
-    model.addCube(
-        position + glm::vec3(-scale * 0.15f, scale * 0.9f, scale * 0.77f),
-        glm::vec3(scale * 0.09f, scale * 0.12f, scale * 0.08f),
-        eyeBlack
-    );
-    // 右眼黑色瞳孔
-    model.addCube(
-        position + glm::vec3(scale * 0.15f, scale * 0.9f, scale * 0.77f),
-        glm::vec3(scale * 0.09f, scale * 0.12f, scale * 0.08f),
-        eyeBlack
-    );
-
-    // 眼睛高光
-    // 主高光 - 左眼上方
-    model.addCube(
-        position + glm::vec3(-scale * 0.17f, scale * 0.93f, scale * 0.79f),
-        glm::vec3(scale * 0.04f, scale * 0.04f, scale * 0.04f),
-        eyeWhite
-    );
-    // 主高光 - 右眼上方
-    model.addCube(
-        position + glm::vec3(scale * 0.13f, scale * 0.93f, scale * 0.79f),
-        glm::vec3(scale * 0.04f, scale * 0.04f, scale * 0.04f),
-        eyeWhite
-    );
-
-    // 次高光 - 左眼中间
-    model.addCube(
-        position + glm::vec3(-scale * 0.13f, scale * 0.9f, scale * 0.79f),
-        glm::vec3(scale * 0.03f, scale * 0.03f, scale * 0.04f),
-        eyeWhite
-    );
-    // 次高光 - 右眼中间
-    model.addCube(
-        position + glm::vec3(scale * 0.17f, scale * 0.9f, scale * 0.79f),
-        glm::vec3(scale * 0.03f, scale * 0.03f, scale * 0.04f),
-        eyeWhite
-    );
-
-    // 小高光 - 左眼下方
-    model.addCube(
-        position + glm::vec3(-scale * 0.15f, scale * 0.87f, scale * 0.79f),
-        glm::vec3(scale * 0.02f, scale * 0.02f, scale * 0.04f),
-        eyeWhite
-    );
-    // 小高光 - 右眼下方
-    model.addCube(
-        position + glm::vec3(scale * 0.15f, scale * 0.87f, scale * 0.79f),
-        glm::vec3(scale * 0.02f, scale * 0.02f, scale * 0.04f),
-        eyeWhite
-    );
-    
-    // 耳朵
-    // 左耳
-    model.addCube(
-        position + glm::vec3(-scale * 0.18f, scale * 1.1f, scale * 0.5f),
-        glm::vec3(scale * 0.15f, scale * 0.3f, scale * 0.15f),
-        mainColor
-    );
-    model.addCube(
-        position + glm::vec3(-scale * 0.18f, scale * 1.1f, scale * 0.52f),
-        glm::vec3(scale * 0.1f, scale * 0.25f, scale * 0.1f),
-        innerEarColor
-    );
-    
-    // 右耳
-    model.addCube(
-        position + glm::vec3(scale * 0.18f, scale * 1.1f, scale * 0.5f),
-        glm::vec3(scale * 0.15f, scale * 0.3f, scale * 0.15f),
-        mainColor
-    );
-    model.addCube(
-        position + glm::vec3(scale * 0.18f, scale * 1.1f, scale * 0.52f),
-        glm::vec3(scale * 0.1f, scale * 0.25f, scale * 0.1f),
-        innerEarColor
-    );
-    
-    // 胡须基座
-    // 左边基座
-    model.addCube(
-        position + glm::vec3(-scale * 0.2f, scale * 0.82f, scale * 0.85f),
-        glm::vec3(scale * 0.08f, scale * 0.08f, scale * 0.08f),
-        mainColor
-    );
-    // 右边基座
-    model.addCube(
-        position + glm::vec3(scale * 0.2f, scale * 0.82f, scale * 0.85f),
-        glm::vec3(scale * 0.08f, scale * 0.08f, scale * 0.08f),
-        mainColor
-    );
-
-    // 左边胡须
-    model.addCube(
-        position + glm::vec3(-scale * 0.35f, scale * 0.85f, scale * 0.85f),
-        glm::vec3(scale * 0.25f, scale * 0.02f, scale * 0.02f),
-        eyeWhite
-    );
-    model.addCube(
-        position + glm::vec3(-scale * 0.35f, scale * 0.82f, scale * 0.85f),
-        glm::vec3(scale * 0.25f, scale * 0.02f, scale * 0.02f),
-        eyeWhite
-    );
-    model.addCube(
-        position + glm::vec3(-scale * 0.35f, scale * 0.79f, scale * 0.85f),
-        glm::vec3(scale * 0.25f, scale * 0.02f, scale * 0.02f),
-        eyeWhite
-    );
-
-    // 右边胡须
-    model.addCube(
-        position + glm::vec3(scale * 0.35f, scale * 0.85f, scale * 0.85f),
-        glm::vec3(scale * 0.25f, scale * 0.02f, scale * 0.02f),
-        eyeWhite
-    );
-    model.addCube(
-        position + glm::vec3(scale * 0.35f, scale * 0.82f, scale * 0.85f),
-        glm::vec3(scale * 0.25f, scale * 0.02f, scale * 0.02f),
-        eyeWhite
-    );
-    model.addCube(
-        position + glm::vec3(scale * 0.35f, scale * 0.79f, scale * 0.85f),
-        glm::vec3(scale * 0.25f, scale * 0.02f, scale * 0.02f),
-        eyeWhite
-    );
-
-    // 腿部
-    // 前腿
-    model.addCube(
-        position + glm::vec3(-scale * 0.2f, scale * 0.2f, scale * 0.3f),
-        glm::vec3(scale * 0.15f, scale * 0.3f, scale * 0.15f),
-        mainColor
-    );
-    model.addCube(
-        position + glm::vec3(scale * 0.2f, scale * 0.2f, scale * 0.3f),
-        glm::vec3(scale * 0.15f, scale * 0.3f, scale * 0.15f),
-        mainColor
-    );
-    
-    // 后腿
-    model.addCube(
-        position + glm::vec3(-scale * 0.2f, scale * 0.2f, -scale * 0.3f),
-        glm::vec3(scale * 0.15f, scale * 0.3f, scale * 0.15f),
-        mainColor
-    );
-    model.addCube(
-        position + glm::vec3(scale * 0.2f, scale * 0.2f, -scale * 0.3f),
-        glm::vec3(scale * 0.15f, scale * 0.3f, scale * 0.15f),
-        mainColor
-    );
-    
-    // 爪子
-    // 前爪
-    model.addCube(
-        position + glm::vec3(-scale * 0.2f, scale * 0.05f, scale * 0.3f),
-        glm::vec3(scale * 0.12f, scale * 0.1f, scale * 0.12f),
-        pawColor
-    );
-    model.addCube(
-        position + glm::vec3(scale * 0.2f, scale * 0.05f, scale * 0.3f),
-        glm::vec3(scale * 0.12f, scale * 0.1f, scale * 0.12f),
-        pawColor
-    );
-    
-    // 后爪
-    model.addCube(
-        position + glm::vec3(-scale * 0.2f, scale * 0.05f, -scale * 0.3f),
-        glm::vec3(scale * 0.12f, scale * 0.1f, scale * 0.12f),
-        pawColor
-    );
-    model.addCube(
-        position + glm::vec3(scale * 0.2f, scale * 0.05f, -scale * 0.3f),
-        glm::vec3(scale * 0.12f, scale * 0.1f, scale * 0.12f),
-        pawColor
-    );
-    
-    // 尾巴 - 使用多个立方体创建弧度
-    // 尾巴根部
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.6f, -scale * 0.6f),
-        glm::vec3(scale * 0.12f, scale * 0.12f, scale * 0.25f),
-        mainColor
-    );
-
-    // 尾巴中部（向上弯曲）
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.7f, -scale * 0.75f),
-        glm::vec3(scale * 0.1f, scale * 0.1f, scale * 0.2f),
-        mainColor
-    );
-
-    // 尾巴第三段（继续向上弯曲）
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.85f, -scale * 0.85f),
-        glm::vec3(scale * 0.09f, scale * 0.09f, scale * 0.18f),
-        mainColor
-    );
-
-    // 尾巴第四段（更细）
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.95f, -scale * 0.9f),
-        glm::vec3(scale * 0.08f, scale * 0.08f, scale * 0.15f),
-        mainColor
-    );
-
-    // 尾巴尖端（最细）
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 1.0f, -scale * 0.95f),
-        glm::vec3(scale * 0.06f, scale * 0.06f, scale * 0.1f),
-        mainColor
-    );
-
-    // 尾巴连接处的平滑过渡
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.65f, -scale * 0.67f),
-        glm::vec3(scale * 0.11f, scale * 0.11f, scale * 0.15f),
-        mainColor
-    );
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.77f, -scale * 0.8f),
-        glm::vec3(scale * 0.095f, scale * 0.095f, scale * 0.15f),
-        mainColor
-    );
-    model.addCube(
-        position + glm::vec3(0.0f, scale * 0.9f, -scale * 0.87f),
-        glm::vec3(scale * 0.085f, scale * 0.085f, scale * 0.12f),
-        mainColor
-    );
-
-    model.setupMesh();
-    return model;
-} 
\ No newline at end of file
+
+    ModelBuilder builder;
+    builder.setPalette(catPalette(CatCoatGray));
+    builder.reserve(CAT_BOX_COUNT);
+    for (const BoxDef& def : CAT_BOXES) {
+        builder.addBox(catBox(def, position, scale));
+    }
+    return builder.finish();
+}
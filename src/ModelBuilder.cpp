@@ -0,0 +1,137 @@
+#include "ModelBuilder.h"
+#include "MeshCache.h"
+#include "Profiler.h"
+
+ModelBuilder::ModelBuilder(std::pmr::memory_resource* scratch) : boxes(scratch) {
+}
+
+void ModelBuilder::reserve(size_t boxCount) {
+    boxes.reserve(boxCount);
+}
+
+void ModelBuilder::addBox(const glm::vec3& position, const glm::vec3& size, const glm::vec3& color) {
+    boxes.push_back(Box{position, size, Model::paletteIndex(palette, color)});
+}
+
+void ModelBuilder::setPalette(const std::vector<glm::vec3>& colors) {
+    palette = colors;
+}
+
+void ModelBuilder::addBox(const Box& box) {
+    boxes.push_back(box);
+}
+
+void ModelBuilder::clear() {
+    boxes.clear();
+}
+
+void ModelBuilder::writeBox(const Box& box, Vertex* out) {
+    for (int face = 0; face < FACES_PER_BOX; face++) {
+        writeFace(box, face, out + face * VERTICES_PER_FACE);
+    }
+}
+
+void ModelBuilder::writeFace(const Box& box, int face, Vertex* out) {
+    float w = box.size.x / 2.0f;
+    float h = box.size.y / 2.0f;
+    float d = box.size.z / 2.0f;
+    const float* normal = CUBE_NORMALS[face];
+    for (size_t i = 0; i < VERTICES_PER_FACE; i++) {
+        const signed char* corner = CUBE_CORNERS[face * VERTICES_PER_FACE + i];
+        Vertex& vertex = out[i];
+        vertex.Position = glm::vec3(cornerOffset(box.position.x, corner[0], w),
+                                    cornerOffset(box.position.y, corner[1], h),
+                                    cornerOffset(box.position.z, corner[2], d));
+        vertex.Normal = glm::vec3(normal[0], normal[1], normal[2]);
+        vertex.Color = static_cast<uint8_t>(box.color);
+        vertex.Part = static_cast<uint8_t>(box.part);
+        vertex.Material = static_cast<uint8_t>(box.material);
+        vertex.Padding = 0;
+    }
+}
+
+void ModelBuilder::computeBounds(glm::vec3& boundsMin, glm::vec3& boundsMax) const {
+    if (boxes.empty()) {
+        boundsMin = boundsMax = glm::vec3(0.0f);
+        return;
+    }
+    boundsMin = boxes[0].position - boxes[0].size / 2.0f;
+    boundsMax = boxes[0].position + boxes[0].size / 2.0f;
+    for (const Box& box : boxes) {
+        boundsMin = glm::min(boundsMin, box.position - box.size / 2.0f);
+        boundsMax = glm::max(boundsMax, box.position + box.size / 2.0f);
+    }
+}
+
+void ModelBuilder::build(std::vector<Vertex>& out) const {
+    PROFILE_SCOPE("ModelBuilder::build");
+
+    // 先清空再按精确大小分配，避免resize时搬运旧内容
+    std::vector<Vertex>().swap(out);
+    out.resize(vertexCount());
+    Vertex* cursor = out.data();
+    for (const Box& box : boxes) {
+        writeBox(box, cursor);
+        cursor += VERTICES_PER_BOX;
+    }
+}
+
+Model ModelBuilder::finish(Model::Residency residency) const {
+    Model model;
+    model.residency = residency;
+    model.palette = palette;
+
+    MeshCache* cache = MeshCache::getDefault();
+    if (cache != nullptr && boxes.size() >= MIN_CACHED_BOXES) {
+        uint64_t key = MeshCache::keyFor(boxes.data(), boxes.size());
+        if (residency == Model::Residency::GpuOnly) {
+            model.setSource(boxes.data(), boxes.size());
+        }
+        if (cache->load(key, model)) {
+            return model;
+        }
+        // 未命中：生成后写入缓存
+        build(model.vertices);
+        glm::vec3 meshMin, meshMax;
+        computeBounds(meshMin, meshMax);
+        cache->store(key, model.vertices.data(), model.vertices.size(), meshMin, meshMax);
+        model.setupMesh();
+        return model;
+    }
+
+    if (residency == Model::Residency::CpuAndGpu || boxes.empty()) {
+        build(model.vertices);
+        model.setupMesh();
+        return model;
+    }
+
+    PROFILE_SCOPE("ModelBuilder::finish(GpuOnly)");
+
+    // 包围盒直接由方块求出
+    computeBounds(model.boundsMin, model.boundsMax);
+    model.setSource(boxes.data(), boxes.size());
+
+    // 顶点直接写入GPU缓冲，CPU端从不生成完整副本
+    Vertex* mapped = model.mapMesh(vertexCount());
+    if (mapped != nullptr) {
+        Vertex* cursor = mapped;
+        for (const Box& box : boxes) {
+            writeBox(box, cursor);
+            cursor += VERTICES_PER_BOX;
+        }
+        if (model.unmapMesh()) {
+            return model;
+        }
+    }
+
+    // 映射失败或缓冲内容失效时退回到普通上传
+    build(model.vertices);
+    model.setupMesh();
+    return model;
+}
+
+std::pmr::memory_resource* ModelBuilder::threadScratch() {
+    // 池中的块在构建结束后归还并被下一次构建复用，稳定后不会再向系统申请内存
+    thread_local std::pmr::unsynchronized_pool_resource pool;
+    return &pool;
+}
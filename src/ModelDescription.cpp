@@ -0,0 +1,515 @@
+#include "ModelDescription.h"
+#include "MeshCache.h"
+#include "ModelBuilder.h"
+#include "PartTransforms.h"
+#include "MaterialTable.h"
+#include "Profiler.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+const int MAX_REPEAT = 1024;
+const size_t MAX_TOKENS = 32;
+
+// 一行最多MAX_TOKENS个记号，#之后为注释；记号更多时overflow为true
+size_t tokenize(std::string_view line, std::string_view* tokens, bool& overflow) {
+    size_t count = 0;
+    size_t i = 0;
+    overflow = false;
+    while (i < line.size()) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) {
+            i++;
+        }
+        if (i >= line.size() || line[i] == '#') {
+            break;
+        }
+        if (count == MAX_TOKENS) {
+            overflow = true;
+            break;
+        }
+        size_t start = i;
+        while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r' && line[i] != '#') {
+            i++;
+        }
+        tokens[count++] = line.substr(start, i - start);
+    }
+    return count;
+}
+
+bool parseFloat(std::string_view token, float& value) {
+    char buffer[64];
+    if (token.empty() || token.size() >= sizeof(buffer)) {
+        return false;
+    }
+    std::memcpy(buffer, token.data(), token.size());
+    buffer[token.size()] = '\0';
+    char* end = nullptr;
+    value = std::strtof(buffer, &end);
+    return end == buffer + token.size();
+}
+
+bool parseVec3(const std::string_view* tokens, glm::vec3& value) {
+    return parseFloat(tokens[0], value.x) && parseFloat(tokens[1], value.y) && parseFloat(tokens[2], value.z);
+}
+
+uint64_t hashBoxes(const std::vector<Box>& boxes) {
+    return MeshCache::hash(boxes.data(), boxes.size() * sizeof(Box));
+}
+
+}
+
+bool ModelDescription::parse(const char* text, size_t length, std::string& error) {
+    PROFILE_FUNCTION();
+
+    name.clear();
+    colorNames.clear();
+    colors.clear();
+    colorMaterials.clear();
+    parts.clear();
+    instances.clear();
+    bones.clear();
+    bones.push_back(Bone{"root", glm::vec3(0.0f)});
+
+    std::unordered_map<std::string_view, size_t> colorIndex;
+    std::unordered_map<std::string, size_t> partIndex;
+    const size_t NO_PART = static_cast<size_t>(-1);
+    size_t currentPart = NO_PART;
+    size_t rootPart = NO_PART;
+
+    std::string_view source(text, length);
+    size_t lineNumber = 0;
+    size_t position = 0;
+    std::string_view tokens[MAX_TOKENS];
+    std::vector<glm::vec3> repeatOffsets;
+
+    auto fail = [&](const std::string& message) {
+        std::ostringstream out;
+        out << "line " << lineNumber << ": " << message;
+        error = out.str();
+        return false;
+    };
+
+    while (position <= source.size()) {
+        size_t newline = source.find('\n', position);
+        if (newline == std::string_view::npos) {
+            newline = source.size();
+        }
+        std::string_view line = source.substr(position, newline - position);
+        position = newline + 1;
+        lineNumber++;
+
+        bool overflow;
+        size_t count = tokenize(line, tokens, overflow);
+        if (overflow) {
+            return fail("too many tokens on line (at most " + std::to_string(MAX_TOKENS) + ")");
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        // 前缀操作
+        size_t t = 0;
+        int mirrorMask = 0;
+        // 多个repeat组合为笛卡尔积，repeatOffsets为每个副本的平移
+        repeatOffsets.assign(1, glm::vec3(0.0f));
+        while (t < count && (tokens[t] == "mirror" || tokens[t] == "repeat")) {
+            if (tokens[t] == "mirror") {
+                if (t + 1 >= count) {
+                    return fail("mirror needs axes (x, y, z)");
+                }
+                for (char axis : tokens[t + 1]) {
+                    if (axis < 'x' || axis > 'z') {
+                        return fail("unknown mirror axis '" + std::string(1, axis) + "'");
+                    }
+                    mirrorMask |= 1 << (axis - 'x');
+                }
+                t += 2;
+            }
+            else {
+                if (t + 4 >= count) {
+                    return fail("repeat needs a count and a step: repeat N dx dy dz");
+                }
+                float countValue;
+                if (!parseFloat(tokens[t + 1], countValue) || countValue < 1.0f || countValue > MAX_REPEAT ||
+                    countValue != static_cast<float>(static_cast<int>(countValue))) {
+                    return fail("repeat count must be an integer between 1 and " + std::to_string(MAX_REPEAT));
+                }
+                int repeat = static_cast<int>(countValue);
+                glm::vec3 step;
+                if (repeatOffsets.size() * repeat > static_cast<size_t>(MAX_REPEAT)) {
+                    return fail("combined repeat count exceeds " + std::to_string(MAX_REPEAT));
+                }
+                if (!parseVec3(tokens + t + 2, step)) {
+                    return fail("bad repeat step");
+                }
+                size_t previous = repeatOffsets.size();
+                for (size_t i = 0; i < previous; i++) {
+                    for (int r = 1; r < repeat; r++) {
+                        repeatOffsets.push_back(repeatOffsets[i] + step * static_cast<float>(r));
+                    }
+                }
+                t += 5;
+            }
+        }
+        if (t >= count) {
+            return fail("missing statement after operator");
+        }
+        bool hasOperators = t > 0;
+        std::string_view keyword = tokens[t];
+        size_t args = count - t - 1;
+        const std::string_view* arg = tokens + t + 1;
+
+        if (keyword == "model" || keyword == "color" || keyword == "part" || keyword == "end" ||
+            keyword == "pivot") {
+            if (hasOperators) {
+                return fail("mirror/repeat only apply to box and use");
+            }
+        }
+
+        if (keyword == "model") {
+            if (args != 1) {
+                return fail("usage: model <name>");
+            }
+            name = std::string(arg[0]);
+        }
+        else if (keyword == "color") {
+            glm::vec3 color;
+            float material = 0.0f;
+            if ((args != 4 && args != 6) || !parseVec3(arg + 1, color) ||
+                (args == 6 && (arg[4] != "material" || !parseFloat(arg[5], material)))) {
+                return fail("usage: color <name> r g b [material <index>]");
+            }
+            if (material < 0.0f || material >= MaterialTable::MAX_MATERIALS ||
+                material != static_cast<float>(static_cast<int>(material))) {
+                return fail("material must be an integer between 0 and " +
+                            std::to_string(MaterialTable::MAX_MATERIALS - 1));
+            }
+            if (colorIndex.count(arg[0]) != 0) {
+                return fail("color '" + std::string(arg[0]) + "' defined twice");
+            }
+            if (colors.size() >= Model::MAX_PALETTE_COLORS) {
+                return fail("too many colors (at most " + std::to_string(Model::MAX_PALETTE_COLORS) + ")");
+            }
+            colorNames.push_back(std::string(arg[0]));
+            colors.push_back(color);
+            colorMaterials.push_back(static_cast<unsigned int>(material));
+            // 键指向源文本，源文本在解析期间有效
+            colorIndex[arg[0]] = colors.size() - 1;
+        }
+        else if (keyword == "part") {
+            if (args != 1) {
+                return fail("usage: part <name>");
+            }
+            if (currentPart != NO_PART) {
+                return fail("parts cannot be nested (missing end?)");
+            }
+            std::string partName(arg[0]);
+            if (partIndex.count(partName) != 0) {
+                return fail("part '" + partName + "' defined twice");
+            }
+            partIndex[partName] = parts.size();
+            currentPart = parts.size();
+            parts.push_back(Part{partName, {}, glm::vec3(0.0f), 0});
+        }
+        else if (keyword == "pivot") {
+            if (currentPart == NO_PART) {
+                return fail("pivot is only allowed inside parts");
+            }
+            if (args != 3 || !parseVec3(arg, parts[currentPart].pivot)) {
+                return fail("usage: pivot x y z");
+            }
+        }
+        else if (keyword == "end") {
+            if (currentPart == NO_PART) {
+                return fail("end without part");
+            }
+            if (parts[currentPart].boxes.empty()) {
+                return fail("part '" + parts[currentPart].name + "' has no boxes");
+            }
+            currentPart = NO_PART;
+        }
+        else if (keyword == "box") {
+            glm::vec3 center, size;
+            if (args != 7 || !parseVec3(arg, center) || !parseVec3(arg + 3, size)) {
+                return fail("usage: box x y z sx sy sz <color>");
+            }
+            if (size.x <= 0.0f || size.y <= 0.0f || size.z <= 0.0f) {
+                return fail("box size must be positive");
+            }
+            auto color = colorIndex.find(arg[6]);
+            if (color == colorIndex.end()) {
+                return fail("unknown color '" + std::string(arg[6]) + "'");
+            }
+
+            size_t target = currentPart;
+            if (target == NO_PART) {
+                if (rootPart == NO_PART) {
+                    rootPart = parts.size();
+                    parts.push_back(Part{"", {}, glm::vec3(0.0f), 0});
+                    instances.push_back(Instance{rootPart, glm::vec3(0.0f), glm::vec3(1.0f), 0});
+                }
+                target = rootPart;
+            }
+            for (const glm::vec3& shift : repeatOffsets) {
+                glm::vec3 base = center + shift;
+                for (int subset = 0; subset < 8; subset++) {
+                    if ((subset & ~mirrorMask) != 0) {
+                        continue;
+                    }
+                    glm::vec3 mirrored = base;
+                    bool duplicate = false;
+                    for (int axis = 0; axis < 3; axis++) {
+                        if (subset & (1 << axis)) {
+                            // 中心在对称面上的方块镜像后与原方块重合
+                            duplicate = duplicate || mirrored[axis] == 0.0f;
+                            mirrored[axis] = -mirrored[axis];
+                        }
+                    }
+                    if (!duplicate) {
+                        parts[target].boxes.push_back(Box{mirrored, size, static_cast<unsigned int>(color->second), 0,
+                                                          colorMaterials[color->second]});
+                    }
+                }
+            }
+        }
+        else if (keyword == "use") {
+            if (currentPart != NO_PART) {
+                return fail("use is only allowed outside parts");
+            }
+            // 可选的"as <bone>"在最后
+            std::string_view boneName;
+            if (args >= 3 && arg[args - 2] == "as") {
+                boneName = arg[args - 1];
+                args -= 2;
+            }
+            glm::vec3 offset(0.0f);
+            if ((args != 1 && args != 4) || (args == 4 && !parseVec3(arg + 1, offset)) ||
+                boneName == "*") {
+                return fail("usage: use <part> [x y z] [as <bone>[*]]");
+            }
+            auto part = partIndex.find(std::string(arg[0]));
+            if (part == partIndex.end()) {
+                return fail("unknown part '" + std::string(arg[0]) + "'");
+            }
+            bool bonePerCopy = !boneName.empty() && boneName.back() == '*';
+            if (bonePerCopy) {
+                boneName.remove_suffix(1);
+            }
+            int copy = 0;
+            for (const glm::vec3& shift : repeatOffsets) {
+                glm::vec3 base = offset + shift;
+                for (int subset = 0; subset < 8; subset++) {
+                    if ((subset & ~mirrorMask) != 0) {
+                        continue;
+                    }
+                    Instance instance{part->second, base, glm::vec3(1.0f), 0};
+                    for (int axis = 0; axis < 3; axis++) {
+                        if (subset & (1 << axis)) {
+                            instance.offset[axis] = -instance.offset[axis];
+                            instance.mirror[axis] = -1.0f;
+                        }
+                    }
+                    if (!boneName.empty()) {
+                        std::string bone(boneName);
+                        if (bonePerCopy) {
+                            bone += std::to_string(copy++);
+                        }
+                        int index = findBone(bone);
+                        if (index < 0) {
+                            if (bones.size() >= PartTransforms::MAX_PARTS) {
+                                return fail("too many bones (at most " +
+                                            std::to_string(PartTransforms::MAX_PARTS) + ")");
+                            }
+                            index = static_cast<int>(bones.size());
+                            bones.push_back(Bone{bone, parts[part->second].pivot * instance.mirror + instance.offset});
+                        }
+                        instance.bone = static_cast<unsigned int>(index);
+                    }
+                    instances.push_back(instance);
+                }
+            }
+        }
+        else {
+            return fail("unknown statement '" + std::string(keyword) + "'");
+        }
+    }
+
+    if (currentPart != NO_PART) {
+        return fail("part '" + parts[currentPart].name + "' is missing end");
+    }
+    if (instances.empty()) {
+        return fail("model has no boxes");
+    }
+
+    dedupeParts();
+    return true;
+}
+
+void ModelDescription::dedupeParts() {
+    for (Part& part : parts) {
+        part.hash = hashBoxes(part.boxes);
+    }
+
+    // 内容相同的部件合并为一个，未被使用的部件丢弃
+    std::vector<size_t> remap(parts.size(), 0);
+    std::vector<char> used(parts.size(), 0);
+    for (const Instance& instance : instances) {
+        used[instance.part] = 1;
+    }
+    std::unordered_map<uint64_t, std::vector<size_t>> byHash;
+    std::vector<Part> unique;
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (!used[i]) {
+            continue;
+        }
+        std::vector<size_t>& candidates = byHash[parts[i].hash];
+        bool merged = false;
+        for (size_t candidate : candidates) {
+            const std::vector<Box>& a = unique[candidate].boxes;
+            const std::vector<Box>& b = parts[i].boxes;
+            if (a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(Box)) == 0) {
+                remap[i] = candidate;
+                merged = true;
+                break;
+            }
+        }
+        if (!merged) {
+            remap[i] = unique.size();
+            candidates.push_back(unique.size());
+            unique.push_back(std::move(parts[i]));
+        }
+    }
+    for (Instance& instance : instances) {
+        instance.part = remap[instance.part];
+    }
+    parts = std::move(unique);
+}
+
+int ModelDescription::findBone(const std::string& boneName) const {
+    for (size_t i = 0; i < bones.size(); i++) {
+        if (bones[i].name == boneName) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool ModelDescription::loadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "ERROR::MODEL::FILE_NOT_FOUND: " << path << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    std::string error;
+    if (!parse(text.data(), text.size(), error)) {
+        std::cerr << "ERROR::MODEL::PARSE_FAILED: " << path << ": " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+size_t ModelDescription::boxCount() const {
+    size_t count = 0;
+    for (const Instance& instance : instances) {
+        count += parts[instance.part].boxes.size();
+    }
+    return count;
+}
+
+void ModelDescription::flatten(std::vector<Box>& out, const glm::vec3& position, float scale) const {
+    out.clear();
+    out.reserve(boxCount());
+    for (const Instance& instance : instances) {
+        for (const Box& box : parts[instance.part].boxes) {
+            out.push_back(Box{position + (box.position * instance.mirror + instance.offset) * scale,
+                              box.size * scale, box.color, instance.bone, box.material});
+        }
+    }
+}
+
+Model ModelDescription::build(const glm::vec3& position, float scale, Model::Residency residency) const {
+    PROFILE_FUNCTION();
+
+    // 每个部件只生成一次顶点（部件空间）
+    std::vector<std::vector<Vertex>> meshes(parts.size());
+    {
+        ModelBuilder builder;
+        for (size_t i = 0; i < parts.size(); i++) {
+            builder.clear();
+            builder.reserve(parts[i].boxes.size());
+            for (const Box& box : parts[i].boxes) {
+                builder.addBox(box);
+            }
+            builder.build(meshes[i]);
+        }
+    }
+
+    size_t total = 0;
+    for (const Instance& instance : instances) {
+        total += meshes[instance.part].size();
+    }
+
+    glm::vec3 boundsMin(0.0f), boundsMax(0.0f);
+    auto writeInstances = [&](Vertex* out) {
+        bool first = true;
+        for (const Instance& instance : instances) {
+            const std::vector<Vertex>& mesh = meshes[instance.part];
+            // 奇数个轴镜像时三角形绕序翻转
+            bool flip = instance.mirror.x * instance.mirror.y * instance.mirror.z < 0.0f;
+            for (size_t v = 0; v < mesh.size(); v++) {
+                size_t target = v;
+                if (flip && v % 3 != 0) {
+                    target = v + (v % 3 == 1 ? 1 : -1);
+                }
+                Vertex& vertex = out[target];
+                vertex.Position = position + (mesh[v].Position * instance.mirror + instance.offset) * scale;
+                vertex.Normal = mesh[v].Normal * instance.mirror;
+                vertex.Color = mesh[v].Color;
+                vertex.Part = static_cast<uint8_t>(instance.bone);
+                vertex.Material = mesh[v].Material;
+                vertex.Padding = 0;
+                boundsMin = first ? vertex.Position : glm::min(boundsMin, vertex.Position);
+                boundsMax = first ? vertex.Position : glm::max(boundsMax, vertex.Position);
+                first = false;
+            }
+            out += mesh.size();
+        }
+    };
+
+    Model model;
+    model.residency = residency;
+    model.palette = colors;
+    if (residency == Model::Residency::GpuOnly) {
+        std::vector<Box> boxes;
+        flatten(boxes, position, scale);
+        model.setSource(boxes.data(), boxes.size());
+
+        Vertex* mapped = model.mapMesh(total);
+        if (mapped != nullptr) {
+            writeInstances(mapped);
+            if (model.unmapMesh()) {
+                model.boundsMin = boundsMin;
+                model.boundsMax = boundsMax;
+                return model;
+            }
+        }
+    }
+
+    model.vertices.resize(total);
+    writeInstances(model.vertices.data());
+    model.uploadMesh(model.vertices.data(), total, boundsMin, boundsMax);
+    if (residency == Model::Residency::GpuOnly) {
+        model.releaseCpuData();
+    }
+    return model;
+}
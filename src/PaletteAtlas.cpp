@@ -0,0 +1,62 @@
+#include "PaletteAtlas.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
+#include "GLState.h"
+#include <GL/glew.h>
+#include <iostream>
+
+PaletteAtlas::PaletteAtlas() : texture(0) {
+}
+
+PaletteAtlas::~PaletteAtlas() {
+    if (texture != 0) {
+        MemoryTracker::get().release(MemoryTracker::Resource::Texture, texture);
+        GLState::get().deleteTexture(texture);
+        glDeleteTextures(1, &texture);
+    }
+}
+
+unsigned int PaletteAtlas::add(const std::vector<glm::vec3>& colors) {
+    if (rows.size() >= MAX_PALETTES) {
+        std::cerr << "Warning: Palette atlas is full (" << MAX_PALETTES << "), using palette 0" << std::endl;
+        return 0;
+    }
+    rows.emplace_back();
+    dirtyRows.push_back(1);
+    unsigned int palette = static_cast<unsigned int>(rows.size() - 1);
+    set(palette, colors);
+    return palette;
+}
+
+void PaletteAtlas::set(unsigned int palette, const std::vector<glm::vec3>& colors) {
+    // 多余的颜色截掉，不足的补黑色
+    std::vector<glm::vec3>& row = rows[palette];
+    row.assign(COLORS, glm::vec3(0.0f));
+    for (size_t i = 0; i < colors.size() && i < COLORS; i++) {
+        row[i] = colors[i];
+    }
+    dirtyRows[palette] = 1;
+}
+
+void PaletteAtlas::bind() {
+    if (texture == 0) {
+        // 按最大行数分配一次；颜色用浮点保存，与原来的顶点颜色完全一致
+        glGenTextures(1, &texture);
+        GLState::get().bindTexture(TEXTURE_UNIT, texture);
+        MemoryTracker::get().texImage2D(texture, GL_RGB32F, COLORS, MAX_PALETTES, GL_RGB, GL_FLOAT, nullptr,
+                                        MemoryCategory::Palette, this, "PaletteAtlas");
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    }
+    GLState::get().bindTexture(TEXTURE_UNIT, texture);
+    for (size_t i = 0; i < rows.size(); i++) {
+        if (dirtyRows[i]) {
+            // 纹理已绑定时当前单元可能是别的单元
+            GLState::get().activeTexture(TEXTURE_UNIT);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, static_cast<GLint>(i), COLORS, 1, GL_RGB, GL_FLOAT, rows[i].data());
+            RenderStats::get().uploadedBytes += COLORS * sizeof(glm::vec3);
+            dirtyRows[i] = 0;
+        }
+    }
+}
@@ -0,0 +1,298 @@
+#include "PaletteLut.h"
+#include "MeshCache.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
+#include "GLState.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(PaletteLut::Header) == 32, "lut header layout changed, bump FORMAT_VERSION");
+
+namespace {
+
+float srgbToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+// 线性RGB转换到OKLab（Björn Ottosson的矩阵）
+glm::vec3 linearToOklab(float r, float g, float b) {
+    float l = std::cbrt(0.4122214708f * r + 0.5363325363f * g + 0.0514459929f * b);
+    float m = std::cbrt(0.2119034982f * r + 0.6806995451f * g + 0.1073969566f * b);
+    float s = std::cbrt(0.0883024619f * r + 0.2817188376f * g + 0.6299787005f * b);
+    return glm::vec3(0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+                     1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+                     0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s);
+}
+
+glm::vec3 hexColor(uint32_t rgb) {
+    return glm::vec3(static_cast<float>((rgb >> 16) & 0xff),
+                     static_cast<float>((rgb >> 8) & 0xff),
+                     static_cast<float>(rgb & 0xff)) / 255.0f;
+}
+
+double nowMs() {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+PaletteLut::PaletteLut()
+    : size(0), lutTexture(0), paletteTexture(0), cached(false), buildMs(0.0) {
+}
+
+PaletteLut::~PaletteLut() {
+    if (lutTexture != 0) {
+        MemoryTracker::get().release(MemoryTracker::Resource::Texture, lutTexture);
+        MemoryTracker::get().release(MemoryTracker::Resource::Texture, paletteTexture);
+        GLState::get().deleteTexture(paletteTexture);
+        glDeleteTextures(1, &lutTexture);
+        glDeleteTextures(1, &paletteTexture);
+    }
+}
+
+glm::vec3 PaletteLut::toOklab(const glm::vec3& srgb) {
+    return linearToOklab(srgbToLinear(srgb.x), srgbToLinear(srgb.y), srgbToLinear(srgb.z));
+}
+
+uint64_t PaletteLut::keyFor(const std::vector<glm::vec3>& colors, unsigned int lutSize) {
+    uint32_t versions[3] = {FORMAT_VERSION, GENERATOR_VERSION, lutSize};
+    uint64_t key = MeshCache::hash(versions, sizeof(versions));
+    return MeshCache::hash(colors.data(), colors.size() * sizeof(glm::vec3), key);
+}
+
+void PaletteLut::generate(const std::vector<glm::vec3>& colors, unsigned int lutSize, uint8_t* indices) {
+    PROFILE_FUNCTION();
+    // 调色板按分量分开存放，最近色的内层循环是连续的乘加
+    size_t count = colors.size();
+    std::vector<float> paletteL(count), paletteA(count), paletteB(count);
+    for (size_t i = 0; i < count; i++) {
+        glm::vec3 lab = toOklab(colors[i]);
+        paletteL[i] = lab.x;
+        paletteA[i] = lab.y;
+        paletteB[i] = lab.z;
+    }
+    // sRGB到线性的转换按通道独立，每个格点坐标只算一次
+    std::vector<float> linear(lutSize);
+    for (unsigned int i = 0; i < lutSize; i++) {
+        linear[i] = srgbToLinear(lutSize > 1 ? static_cast<float>(i) / (lutSize - 1) : 0.0f);
+    }
+
+    // 每个任务处理若干行（固定g、b，r从0到size-1）
+    size_t rows = static_cast<size_t>(lutSize) * lutSize;
+    JobSystem::get().parallelFor(rows, lutSize, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++) {
+            float g = linear[row % lutSize];
+            float b = linear[row / lutSize];
+            uint8_t* out = indices + row * lutSize;
+            for (unsigned int r = 0; r < lutSize; r++) {
+                glm::vec3 lab = linearToOklab(linear[r], g, b);
+                float best = std::numeric_limits<float>::max();
+                size_t bestIndex = 0;
+                for (size_t i = 0; i < count; i++) {
+                    float dl = lab.x - paletteL[i];
+                    float da = lab.y - paletteA[i];
+                    float db = lab.z - paletteB[i];
+                    float distance = dl * dl + da * da + db * db;
+                    if (distance < best) {
+                        best = distance;
+                        bestIndex = i;
+                    }
+                }
+                out[r] = static_cast<uint8_t>(bestIndex);
+            }
+        }
+    });
+}
+
+bool PaletteLut::build(const std::vector<glm::vec3>& colors, unsigned int lutSize, const std::string& cacheDirectory) {
+    PROFILE_FUNCTION();
+    if (colors.empty() || colors.size() > MAX_COLORS) {
+        std::cerr << "ERROR::PALETTE_LUT::INVALID_PALETTE: " << colors.size() << " colors (1~" << MAX_COLORS
+                  << " supported)" << std::endl;
+        return false;
+    }
+    lutSize = std::max(2u, std::min(lutSize, 256u));
+    double start = nowMs();
+    palette = colors;
+    size = lutSize;
+
+    uint64_t key = keyFor(palette, size);
+    std::string path;
+    if (!cacheDirectory.empty()) {
+        std::ostringstream name;
+        name << cacheDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".lut";
+        path = name.str();
+    }
+
+    cached = !path.empty() && loadCache(path, key);
+    if (!cached) {
+        std::vector<uint8_t> indices(static_cast<size_t>(size) * size * size);
+        generate(palette, size, indices.data());
+        upload(indices.data());
+        if (!path.empty()) {
+            std::error_code error;
+            std::filesystem::create_directories(cacheDirectory, error);
+            storeCache(path, key, indices);
+        }
+    }
+    buildMs = nowMs() - start;
+    return true;
+}
+
+bool PaletteLut::loadCache(const std::string& path, uint64_t key) {
+    PROFILE_FUNCTION();
+    size_t dataSize = static_cast<size_t>(size) * size * size;
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    const unsigned char* data = static_cast<const unsigned char*>(mapping);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<unsigned char> fileData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    size_t fileSize = fileData.size();
+    const unsigned char* data = fileData.data();
+#endif
+
+    Header header;
+    bool valid = fileSize >= sizeof(Header);
+    if (valid) {
+        std::memcpy(&header, data, sizeof(Header));
+        valid = header.magic == MAGIC &&
+                header.formatVersion == FORMAT_VERSION &&
+                header.generatorVersion == GENERATOR_VERSION &&
+                header.size == size &&
+                header.key == key &&
+                header.colorCount == palette.size() &&
+                fileSize - sizeof(Header) >= dataSize;
+    }
+    if (valid) {
+        // 映射区直接作为上传源
+        upload(data + sizeof(Header));
+    }
+    else {
+        std::cerr << "Warning: ignoring stale or corrupt palette LUT cache " << path << std::endl;
+    }
+
+#ifndef _WIN32
+    munmap(mapping, fileSize);
+#endif
+    return valid;
+}
+
+bool PaletteLut::storeCache(const std::string& path, uint64_t key, const std::vector<uint8_t>& indices) const {
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = MAGIC;
+    header.formatVersion = FORMAT_VERSION;
+    header.generatorVersion = GENERATOR_VERSION;
+    header.size = size;
+    header.key = key;
+    header.colorCount = static_cast<uint32_t>(palette.size());
+
+    // 先写临时文件再改名，不会留下半个文件
+    std::string temporary = MeshCache::temporaryPath(path);
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Warning: cannot write palette LUT cache " << temporary << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(indices.size()));
+        if (!file) {
+            std::cerr << "Warning: failed to write palette LUT cache " << temporary << std::endl;
+            file.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+void PaletteLut::upload(const uint8_t* indices) {
+    if (lutTexture == 0) {
+        glGenTextures(1, &lutTexture);
+        glGenTextures(1, &paletteTexture);
+    }
+
+    // 整数纹理只能用NEAREST过滤
+    GLState::get().bindTexture(LUT_TEXTURE_UNIT, lutTexture, GL_TEXTURE_3D);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    MemoryTracker::get().texImage3D(lutTexture, GL_R8UI, size, size, size, GL_RED_INTEGER, GL_UNSIGNED_BYTE,
+                                    indices, MemoryCategory::Palette, this, "PaletteLut");
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAX_LEVEL, 0);
+    RenderStats::get().uploadedBytes += static_cast<size_t>(size) * size * size;
+
+    GLState::get().bindTexture(PALETTE_TEXTURE_UNIT, paletteTexture);
+    MemoryTracker::get().texImage2D(paletteTexture, GL_RGB32F, static_cast<int>(palette.size()), 1, GL_RGB, GL_FLOAT,
+                                    palette.data(), MemoryCategory::Palette, this, "PaletteLut");
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    RenderStats::get().uploadedBytes += palette.size() * sizeof(glm::vec3);
+}
+
+void PaletteLut::bind() const {
+    GLState::get().bindTexture(LUT_TEXTURE_UNIT, lutTexture, GL_TEXTURE_3D);
+    GLState::get().bindTexture(PALETTE_TEXTURE_UNIT, paletteTexture);
+}
+
+std::vector<glm::vec3> PaletteLut::createPico8() {
+    static const uint32_t colors[16] = {
+        0x000000, 0x1d2b53, 0x7e2553, 0x008751, 0xab5236, 0x5f574f, 0xc2c3c7, 0xfff1e8,
+        0xff004d, 0xffa300, 0xffec27, 0x00e436, 0x29adff, 0x83769c, 0xff77a8, 0xffccaa
+    };
+    std::vector<glm::vec3> palette;
+    for (uint32_t color : colors) {
+        palette.push_back(hexColor(color));
+    }
+    return palette;
+}
@@ -0,0 +1,80 @@
+#include "PartTransforms.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
+#include "GLState.h"
+#include <GL/glew.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+// std140布局下mat4数组的步长就是16个float
+static_assert(sizeof(glm::mat4) == 64, "PartTransforms expects tightly packed mat4");
+
+PartTransforms::PartTransforms() : UBO(0), usedParts(1), dirty(true) {
+    reset();
+}
+
+PartTransforms::~PartTransforms() {
+    if (UBO != 0) {
+        MemoryTracker::get().release(MemoryTracker::Resource::Buffer, UBO);
+        GLState::get().deleteBuffer(UBO);
+        glDeleteBuffers(1, &UBO);
+    }
+}
+
+void PartTransforms::reset() {
+    for (unsigned int i = 0; i < MAX_PARTS; i++) {
+        transforms[i] = glm::mat4(1.0f);
+    }
+    dirty = true;
+}
+
+void PartTransforms::set(unsigned int part, const glm::mat4& transform) {
+    if (part >= MAX_PARTS) {
+        return;
+    }
+    transforms[part] = transform;
+    usedParts = part + 1 > usedParts ? part + 1 : usedParts;
+    dirty = true;
+}
+
+void PartTransforms::set(const glm::mat4* source, unsigned int count) {
+    count = count < MAX_PARTS ? count : MAX_PARTS;
+    for (unsigned int i = 0; i < count; i++) {
+        transforms[i] = source[i];
+    }
+    usedParts = count > usedParts ? count : usedParts;
+    dirty = true;
+}
+
+void PartTransforms::rotate(unsigned int part, const glm::vec3& pivot, float angle, const glm::vec3& axis,
+                            const glm::mat4& parent) {
+    glm::mat4 local = glm::translate(glm::mat4(1.0f), pivot);
+    local = glm::rotate(local, angle, axis);
+    local = glm::translate(local, -pivot);
+    set(part, parent * local);
+}
+
+void PartTransforms::bind() {
+    if (UBO == 0) {
+        // 按最大部件数分配一次，之后只更新用到的部分
+        glGenBuffers(1, &UBO);
+        GLState::get().bindBuffer(GL_UNIFORM_BUFFER, UBO);
+        MemoryTracker::get().bufferData(GL_UNIFORM_BUFFER, UBO, MAX_PARTS * sizeof(glm::mat4), transforms,
+                                        GL_DYNAMIC_DRAW, MemoryCategory::Uniform, this, "PartTransforms");
+        RenderStats::get().uploadedBytes += MAX_PARTS * sizeof(glm::mat4);
+        dirty = false;
+    }
+    else if (dirty) {
+        GLState::get().bindBuffer(GL_UNIFORM_BUFFER, UBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, usedParts * sizeof(glm::mat4), glm::value_ptr(transforms[0]));
+        RenderStats::get().uploadedBytes += usedParts * sizeof(glm::mat4);
+        dirty = false;
+    }
+    GLState::get().bindUniformBuffer(BINDING, UBO);
+}
+
+void PartTransforms::bindIdentity() {
+    // 与GL上下文同生命周期，不在静态析构时释放（那时上下文已经销毁）
+    static PartTransforms* identity = new PartTransforms();
+    identity->bind();
+}
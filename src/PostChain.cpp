@@ -0,0 +1,257 @@
+#include "PostChain.h"
+#include "MemoryTracker.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const char* SCREEN_VERTEX_PATH = "shaders/post/screen.vs";
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    contents = stream.str();
+    return true;
+}
+
+}
+
+PostChain::PostChain(RenderTargetPool& targetPool)
+    : uniformVersion(1), targetPool(targetPool), width(0), height(0), fusion(true), dirty(true) {
+    if (!readFile(SCREEN_VERTEX_PATH, vertexCode)) {
+        std::cout << "ERROR::POST_CHAIN::FILE_NOT_SUCCESSFULLY_READ: " << SCREEN_VERTEX_PATH << std::endl;
+    }
+}
+
+PostChain::~PostChain() {
+    GLState::get().useProgram(0);
+    for (auto& program : programs) {
+        glDeleteProgram(program.second->ID);
+    }
+}
+
+bool PostChain::addStage(const std::string& name, StageKind kind, const std::string& path) {
+    std::string code;
+    if (!readFile(path, code)) {
+        std::cout << "ERROR::POST_CHAIN::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+        return false;
+    }
+    addStageSource(name, kind, code);
+    return true;
+}
+
+void PostChain::addStageSource(const std::string& name, StageKind kind, const std::string& code) {
+    stages.push_back(Stage{name, kind, code, true});
+    dirty = true;
+}
+
+void PostChain::setEnabled(const std::string& name, bool enabled) {
+    for (Stage& stage : stages) {
+        if (stage.name == name && stage.enabled != enabled) {
+            stage.enabled = enabled;
+            dirty = true;
+        }
+    }
+}
+
+bool PostChain::isEnabled(const std::string& name) const {
+    for (const Stage& stage : stages) {
+        if (stage.name == name) {
+            return stage.enabled;
+        }
+    }
+    return false;
+}
+
+void PostChain::setFusion(bool enabled) {
+    if (fusion != enabled) {
+        fusion = enabled;
+        dirty = true;
+    }
+}
+
+void PostChain::setUniform(const std::string& name, const Uniform& uniform) {
+    auto found = uniforms.find(name);
+    if (found != uniforms.end() && found->second.type == uniform.type &&
+        found->second.intValue == uniform.intValue && found->second.value == uniform.value) {
+        return;
+    }
+    uniforms[name] = uniform;
+    uniformVersion++;
+}
+
+void PostChain::setInt(const std::string& name, int value) {
+    setUniform(name, Uniform{Uniform::Type::Int, value, glm::vec3(0.0f)});
+}
+
+void PostChain::setFloat(const std::string& name, float value) {
+    setUniform(name, Uniform{Uniform::Type::Float, 0, glm::vec3(value, 0.0f, 0.0f)});
+}
+
+void PostChain::setVec2(const std::string& name, const glm::vec2& value) {
+    setUniform(name, Uniform{Uniform::Type::Vec2, 0, glm::vec3(value.x, value.y, 0.0f)});
+}
+
+void PostChain::setVec3(const std::string& name, const glm::vec3& value) {
+    setUniform(name, Uniform{Uniform::Type::Vec3, 0, value});
+}
+
+std::string PostChain::generate(const Pass& pass) const {
+    std::ostringstream code;
+    code << "#version 330 core\n"
+         << "in vec2 TexCoords;\n"
+         << "out vec4 FragColor;\n"
+         << "uniform sampler2D source;\n"
+         << "uniform vec2 sourceScale;\n"
+         << "uniform vec2 sourceMax;\n"
+         << "\n// 输入目标可能大于有效区域：把[0, 1]换算到有效区域，并限制在最后一个有效像素的中心以内\n"
+         << "vec4 sampleSource(vec2 uv) {\n"
+         << "    return texture(source, min(uv * sourceScale, sourceMax));\n"
+         << "}\n";
+    for (size_t index : pass.stages) {
+        code << "\n// ---- " << stages[index].name << " ----\n" << stages[index].code << "\n";
+    }
+    code << "\nvoid main() {\n";
+    // 只有第一个阶段可以是Sample阶段，它直接读取输入纹理
+    size_t first = 0;
+    if (!pass.stages.empty() && stages[pass.stages[0]].kind == StageKind::Sample) {
+        code << "    vec4 color = " << stages[pass.stages[0]].name << "(TexCoords);\n";
+        first = 1;
+    }
+    else {
+        code << "    vec4 color = sampleSource(TexCoords);\n";
+    }
+    for (size_t i = first; i < pass.stages.size(); i++) {
+        code << "    color = " << stages[pass.stages[i]].name << "(color, TexCoords);\n";
+    }
+    code << "    FragColor = color;\n"
+         << "}\n";
+    return code.str();
+}
+
+void PostChain::build() {
+    PROFILE_FUNCTION();
+    passes.clear();
+    for (size_t i = 0; i < stages.size(); i++) {
+        if (!stages[i].enabled) {
+            continue;
+        }
+        // Sample阶段读取的是上一个通道的完整输出，必须开始新通道
+        bool split = passes.empty() || !fusion || stages[i].kind == StageKind::Sample;
+        if (split) {
+            passes.push_back(Pass{{}, nullptr});
+        }
+        passes.back().stages.push_back(i);
+    }
+    if (passes.empty()) {
+        passes.push_back(Pass{{}, nullptr});
+    }
+
+    for (Pass& pass : passes) {
+        std::string source = generate(pass);
+        std::unique_ptr<Shader>& program = programs[source];
+        if (!program) {
+            program = std::make_unique<Shader>(Shader::fromSource(vertexCode, source));
+            program->use();
+            program->setInt("source", 0);
+        }
+        pass.program = program.get();
+    }
+    dirty = false;
+}
+
+void PostChain::run(const RenderTargetPool::Target& input, unsigned int outputFramebuffer,
+                    int outputWidth, int outputHeight) {
+    PROFILE_FUNCTION();
+    if (dirty) {
+        build();
+    }
+    width = outputWidth;
+    height = outputHeight;
+
+    // 中间目标不需要深度；借到的目标在下一个通道读完后立即归还，池中最多同时借出两个
+    RenderTargetPool::Desc desc{width, height, GL_RGB, false};
+    RenderTargetPool::Target source = input;
+    bool borrowed = false;
+    for (size_t i = 0; i < passes.size(); i++) {
+        bool last = i + 1 == passes.size();
+        RenderTargetPool::Target target;
+        if (last) {
+            GLState::get().bindFramebuffer(outputFramebuffer);
+            GLState::get().viewport(0, 0, width, height);
+        }
+        else {
+            target = targetPool.acquire(desc);
+            target.bind();
+        }
+
+        Shader& program = *passes[i].program;
+        program.use();
+        uint64_t& version = programVersions[program.ID];
+        if (version != uniformVersion) {
+            for (const auto& entry : uniforms) {
+                const Uniform& uniform = entry.second;
+                switch (uniform.type) {
+                    case Uniform::Type::Int:
+                        program.setInt(entry.first, uniform.intValue);
+                        break;
+                    case Uniform::Type::Float:
+                        program.setFloat(entry.first, uniform.value.x);
+                        break;
+                    case Uniform::Type::Vec2:
+                        program.setVec2(entry.first, glm::vec2(uniform.value.x, uniform.value.y));
+                        break;
+                    case Uniform::Type::Vec3:
+                        program.setVec3(entry.first, uniform.value);
+                        break;
+                }
+            }
+            version = uniformVersion;
+        }
+        // 有效区域随输入目标变化，每个通道单独设置
+        glm::vec2 scale = source.uvScale();
+        program.setVec2("sourceScale", scale);
+        program.setVec2("sourceMax", glm::vec2((source.width - 0.5f) / source.framebuffer->getWidth(),
+                                               (source.height - 0.5f) / source.framebuffer->getHeight()));
+
+        GLState::get().bindTexture(0, source.texture());
+        quad.draw();
+        if (borrowed) {
+            targetPool.release(source);
+        }
+        if (!last) {
+            source = target;
+            borrowed = true;
+        }
+    }
+}
+
+size_t PostChain::getPassCount() {
+    if (dirty) {
+        build();
+    }
+    return passes.size();
+}
+
+uint64_t PostChain::getBandwidthBytes() {
+    // 每个通道读一次、写一次整个目标（邻域读取大多命中纹理缓存，不重复计算）
+    uint64_t targetBytes = static_cast<uint64_t>(width) * static_cast<uint64_t>(height) *
+                           MemoryTracker::bytesPerPixel(GL_RGB);
+    return getPassCount() * targetBytes * 2;
+}
+
+std::string PostChain::getPassSource(size_t pass) {
+    if (dirty) {
+        build();
+    }
+    return pass < passes.size() ? generate(passes[pass]) : std::string();
+}
@@ -0,0 +1,143 @@
+#include "Profiler.h"
+
+#ifdef PIXELART3D_PROFILE
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const size_t CHUNK_EVENTS = 8192;
+
+// 每个线程的事件按块存储，只有所属线程写入；count用release发布，导出线程acquire读取
+struct Chunk {
+    Profiler::Event events[CHUNK_EVENTS];
+    std::atomic<size_t> count{0};
+    std::atomic<Chunk*> next{nullptr};
+};
+
+struct ThreadBuffer {
+    Chunk* head;
+    Chunk* tail;                        // 仅所属线程访问
+    uint32_t threadId;
+    std::atomic<const char*> name{nullptr};
+    ThreadBuffer* nextBuffer;           // 注册表链表，发布后不再修改
+};
+
+std::atomic<ThreadBuffer*> registry{nullptr};
+std::atomic<uint32_t> nextThreadId{1};
+
+// 线程退出后缓冲区仍保留在注册表中，保证导出时事件完整，因此不释放
+ThreadBuffer* registerThread() {
+    ThreadBuffer* buffer = new ThreadBuffer();
+    buffer->head = new Chunk();
+    buffer->tail = buffer->head;
+    buffer->threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    buffer->nextBuffer = registry.load(std::memory_order_relaxed);
+    while (!registry.compare_exchange_weak(buffer->nextBuffer, buffer,
+                                           std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return buffer;
+}
+
+ThreadBuffer* threadBuffer() {
+    thread_local ThreadBuffer* buffer = registerThread();
+    return buffer;
+}
+
+void writeEscaped(std::ostream& out, const char* text) {
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+}
+
+}
+
+int64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::record(const char* name, int64_t startNs, int64_t endNs) {
+    ThreadBuffer* buffer = threadBuffer();
+    Chunk* chunk = buffer->tail;
+    size_t index = chunk->count.load(std::memory_order_relaxed);
+    if (index == CHUNK_EVENTS) {
+        Chunk* next = new Chunk();
+        chunk->next.store(next, std::memory_order_release);
+        buffer->tail = next;
+        chunk = next;
+        index = 0;
+    }
+    Event& event = chunk->events[index];
+    event.name = name;
+    event.startNs = startNs;
+    event.durationNs = endNs - startNs;
+    chunk->count.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char* name) {
+    threadBuffer()->name.store(name, std::memory_order_release);
+}
+
+size_t Profiler::eventCount() {
+    size_t total = 0;
+    for (ThreadBuffer* buffer = registry.load(std::memory_order_acquire); buffer != nullptr;
+         buffer = buffer->nextBuffer) {
+        for (Chunk* chunk = buffer->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire)) {
+            total += chunk->count.load(std::memory_order_acquire);
+        }
+    }
+    return total;
+}
+
+bool Profiler::dumpChromeTrace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "ERROR::PROFILER::CANNOT_WRITE " << path << std::endl;
+        return false;
+    }
+
+    // 时间戳为steady_clock的绝对微秒值，与GpuProfiler导出的trace使用同一时间轴
+    file << "{\"traceEvents\":[\n";
+    file << std::fixed << std::setprecision(3);
+    bool first = true;
+    size_t written = 0;
+    for (ThreadBuffer* buffer = registry.load(std::memory_order_acquire); buffer != nullptr;
+         buffer = buffer->nextBuffer) {
+        const char* name = buffer->name.load(std::memory_order_acquire);
+        if (name != nullptr) {
+            file << (first ? "" : ",\n")
+                 << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->threadId
+                 << ",\"args\":{\"name\":\"";
+            writeEscaped(file, name);
+            file << "\"}}";
+            first = false;
+        }
+
+        for (Chunk* chunk = buffer->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire)) {
+            size_t count = chunk->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; i++) {
+                const Event& event = chunk->events[i];
+                file << (first ? "" : ",\n") << "{\"name\":\"";
+                writeEscaped(file, event.name);
+                file << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadId
+                     << ",\"ts\":" << static_cast<double>(event.startNs) / 1000.0
+                     << ",\"dur\":" << static_cast<double>(event.durationNs) / 1000.0 << "}";
+                first = false;
+            }
+            written += count;
+        }
+    }
+    file << "\n]}\n";
+
+    std::cout << "CPU trace written to " << path << " (" << written << " events)" << std::endl;
+    return true;
+}
+
+#endif
@@ -0,0 +1,146 @@
+#include "RenderQueue.h"
+#include "Shader.h"
+#include "Model.h"
+#include "PartTransforms.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace {
+
+const uint32_t DEPTH_BITS = 24;
+const uint32_t DEPTH_MAX = (1u << DEPTH_BITS) - 1;
+
+}
+
+void RenderQueue::clear(float depthRange) {
+    depthScale = depthRange > 0.0f ? DEPTH_MAX / depthRange : 0.0f;
+    draws.clear();
+    keys.clear();
+    order.clear();
+    programs.clear();
+}
+
+uint32_t RenderQueue::programKey(const Shader* program) {
+    // 一帧只有少数几个程序，线性查找即可
+    for (size_t i = 0; i < programs.size(); i++) {
+        if (programs[i] == program) {
+            return static_cast<uint32_t>(i);
+        }
+    }
+    programs.push_back(program);
+    return static_cast<uint32_t>(programs.size() - 1) & 0xff;
+}
+
+void RenderQueue::push(Pass pass, uint32_t meshKey, float depth, const Draw& draw) {
+    float scaled = std::min(std::max(depth * depthScale, 0.0f), static_cast<float>(DEPTH_MAX));
+    uint64_t depthKey = static_cast<uint64_t>(scaled);
+    uint64_t state = (static_cast<uint64_t>(programKey(draw.program)) << 28) |
+                     (static_cast<uint64_t>(draw.material & 0xfff) << 16) | (meshKey & 0xffff);
+    uint64_t key = static_cast<uint64_t>(pass) << 60;
+    if (pass == Pass::Transparent) {
+        key |= (static_cast<uint64_t>(DEPTH_MAX - depthKey) << 36) | state;
+    }
+    else {
+        key |= (state << DEPTH_BITS) | depthKey;
+    }
+    keys.push_back(key);
+    draws.push_back(draw);
+}
+
+void RenderQueue::sort() {
+    PROFILE_FUNCTION();
+
+    size_t count = keys.size();
+    order.resize(count);
+    scratchKeys.resize(count);
+    scratchOrder.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+
+    // LSD基数排序，每次8位；一遍统计出全部8个字节的直方图，所有键在某字节上相同时跳过该遍
+    uint32_t histograms[8][256] = {};
+    for (uint64_t key : keys) {
+        for (int digit = 0; digit < 8; digit++) {
+            histograms[digit][(key >> (digit * 8)) & 0xff]++;
+        }
+    }
+    for (int digit = 0; digit < 8; digit++) {
+        uint32_t* histogram = histograms[digit];
+        if (count == 0 || histogram[(keys[0] >> (digit * 8)) & 0xff] == count) {
+            continue;
+        }
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint32_t target = histogram[(keys[i] >> (digit * 8)) & 0xff]++;
+            scratchKeys[target] = keys[i];
+            scratchOrder[target] = order[i];
+        }
+        keys.swap(scratchKeys);
+        order.swap(scratchOrder);
+    }
+}
+
+void RenderQueue::submit() {
+    PROFILE_FUNCTION();
+
+    stats = Stats();
+    Shader* currentProgram = nullptr;
+    uint32_t currentMaterial = 0;
+    uint32_t currentPalette = 0;
+    bool materialSet = false;
+    bool paletteSet = false;
+    const Model* currentMesh = nullptr;
+    PartTransforms* currentPose = nullptr;
+    bool poseBound = false;
+    for (uint32_t index : order) {
+        const Draw& draw = draws[index];
+        if (draw.program != currentProgram) {
+            draw.program->use();
+            currentProgram = draw.program;
+            // uniform属于程序，换程序后需要重新设置材质基址和调色板
+            materialSet = false;
+            paletteSet = false;
+            stats.programChanges++;
+        }
+        if (!materialSet || draw.material != currentMaterial) {
+            currentProgram->setInt("materialBase", static_cast<int>(draw.material));
+            currentMaterial = draw.material;
+            materialSet = true;
+            stats.materialChanges++;
+        }
+        if (!paletteSet || draw.palette != currentPalette) {
+            currentProgram->setInt("paletteRow", static_cast<int>(draw.palette));
+            currentPalette = draw.palette;
+            paletteSet = true;
+            stats.paletteChanges++;
+        }
+        if (!poseBound || draw.pose != currentPose) {
+            if (draw.pose) {
+                draw.pose->bind();
+            }
+            else {
+                PartTransforms::bindIdentity();
+            }
+            currentPose = draw.pose;
+            poseBound = true;
+            stats.poseChanges++;
+        }
+        if (draw.mesh != currentMesh) {
+            if (!draw.mesh->bindMesh()) {
+                continue;
+            }
+            currentMesh = draw.mesh;
+            stats.meshChanges++;
+        }
+
+        currentProgram->setMat4("model", *draw.transform);
+        draw.mesh->drawBound();
+        stats.draws++;
+    }
+}
@@ -0,0 +1,111 @@
+#include "RenderTargetPool.h"
+#include "MemoryTracker.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace {
+
+int roundUp(int value, int granularity) {
+    value = std::max(1, value);
+    return (value + granularity - 1) / granularity * granularity;
+}
+
+}
+
+void RenderTargetPool::Target::bind() const {
+    GLState::get().bindFramebuffer(framebuffer->FBO);
+    GLState::get().viewport(0, 0, width, height);
+}
+
+RenderTargetPool::RenderTargetPool(int bucket) : bucket(std::max(1, bucket)), frame(0) {
+}
+
+size_t RenderTargetPool::targetBytes(const Framebuffer& framebuffer) {
+    size_t pixels = static_cast<size_t>(framebuffer.getWidth()) * static_cast<size_t>(framebuffer.getHeight());
+    size_t bytes = pixels * MemoryTracker::bytesPerPixel(framebuffer.getColorFormat());
+    if (framebuffer.hasDepth()) {
+        bytes += pixels * MemoryTracker::bytesPerPixel(GL_DEPTH24_STENCIL8);
+    }
+    return bytes;
+}
+
+RenderTargetPool::Target RenderTargetPool::acquire(const Desc& desc) {
+    int width = std::max(1, desc.width);
+    int height = std::max(1, desc.height);
+    int bucketWidth = roundUp(width, bucket);
+    int bucketHeight = roundUp(height, bucket);
+    size_t bucketArea = static_cast<size_t>(bucketWidth) * static_cast<size_t>(bucketHeight);
+
+    // 在格式相同、放得下、面积不超过取整尺寸两倍的空闲目标中选最小的
+    Entry* best = nullptr;
+    size_t bestArea = 0;
+    for (Entry& entry : entries) {
+        const Framebuffer& framebuffer = *entry.framebuffer;
+        if (entry.inUse || framebuffer.getColorFormat() != desc.colorFormat || framebuffer.hasDepth() != desc.depth ||
+            framebuffer.getWidth() < width || framebuffer.getHeight() < height) {
+            continue;
+        }
+        size_t area = static_cast<size_t>(framebuffer.getWidth()) * static_cast<size_t>(framebuffer.getHeight());
+        if (area <= bucketArea * 2 && (!best || area < bestArea)) {
+            best = &entry;
+            bestArea = area;
+        }
+    }
+
+    if (best) {
+        stats.reuses++;
+    }
+    else {
+        PROFILE_SCOPE("RenderTargetPool::allocate");
+        entries.push_back(Entry{std::make_unique<Framebuffer>(bucketWidth, bucketHeight, MemoryCategory::RenderTarget,
+                                                              desc.colorFormat, desc.depth),
+                                false, frame});
+        best = &entries.back();
+        stats.allocations++;
+        stats.liveTargets++;
+        stats.liveBytes += targetBytes(*best->framebuffer);
+    }
+    best->inUse = true;
+    best->lastUsedFrame = frame;
+
+    Target target;
+    target.framebuffer = best->framebuffer.get();
+    target.width = width;
+    target.height = height;
+    return target;
+}
+
+void RenderTargetPool::release(const Target& target) {
+    for (Entry& entry : entries) {
+        if (entry.framebuffer.get() == target.framebuffer) {
+            entry.inUse = false;
+            entry.lastUsedFrame = frame;
+            return;
+        }
+    }
+}
+
+void RenderTargetPool::evict(size_t index) {
+    stats.liveTargets--;
+    stats.liveBytes -= targetBytes(*entries[index].framebuffer);
+    stats.evictions++;
+    entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+void RenderTargetPool::endFrame() {
+    frame++;
+    for (size_t i = entries.size(); i-- > 0;) {
+        if (!entries[i].inUse && frame - entries[i].lastUsedFrame > EVICT_FRAMES) {
+            evict(i);
+        }
+    }
+}
+
+void RenderTargetPool::trim() {
+    for (size_t i = entries.size(); i-- > 0;) {
+        if (!entries[i].inUse) {
+            evict(i);
+        }
+    }
+}
@@ -0,0 +1,236 @@
+#include "Scene.h"
+#include "Shader.h"
+#include "Profiler.h"
+#include <cmath>
+
+namespace {
+
+const uint32_t INVALID_INDEX = 0xffffffffu;
+
+}
+
+Scene::MeshId Scene::addMesh(Model&& model) {
+    revision++;
+    meshPalettes.push_back(paletteAtlas.add(model.palette));
+    meshes.push_back(std::move(model));
+    return static_cast<MeshId>(meshes.size() - 1);
+}
+
+void Scene::setMesh(MeshId mesh, Model&& model) {
+    revision++;
+    paletteAtlas.set(meshPalettes[mesh], model.palette);
+    meshes[mesh] = std::move(model);
+    for (size_t i = 0; i < entities.meshes.size(); i++) {
+        if (entities.meshes[i] == mesh) {
+            entities.dirty[i] = 1;
+        }
+    }
+}
+
+Scene::MaterialId Scene::addMaterial(const Material& material) {
+    revision++;
+    return materials.add(material);
+}
+
+Scene::PaletteId Scene::addPalette(const std::vector<glm::vec3>& colors) {
+    revision++;
+    return paletteAtlas.add(colors);
+}
+
+Scene::EntityId Scene::createEntity(MeshId mesh, MaterialId material, const glm::vec3& position,
+                                    float yaw, float scale) {
+    revision++;
+    EntityId id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    else {
+        id = static_cast<EntityId>(entityIndex.size());
+        entityIndex.push_back(INVALID_INDEX);
+    }
+    entityIndex[id] = static_cast<uint32_t>(entities.ids.size());
+
+    entities.positions.push_back(position);
+    entities.yaws.push_back(yaw);
+    entities.scales.push_back(scale);
+    entities.transforms.push_back(glm::mat4(1.0f));
+    entities.boundsMin.push_back(position);
+    entities.boundsMax.push_back(position);
+    entities.meshes.push_back(mesh);
+    entities.materials.push_back(material);
+    entities.poses.push_back(NO_POSE);
+    entities.palettes.push_back(NO_PALETTE);
+    entities.visible.push_back(0);
+    entities.dirty.push_back(1);
+    entities.ids.push_back(id);
+    return id;
+}
+
+void Scene::destroyEntity(EntityId entity) {
+    uint32_t index = entityIndex[entity];
+    if (index == INVALID_INDEX) {
+        return;
+    }
+    // 最后一个实体移到空位
+    uint32_t last = static_cast<uint32_t>(entities.ids.size() - 1);
+    if (index != last) {
+        entities.positions[index] = entities.positions[last];
+        entities.yaws[index] = entities.yaws[last];
+        entities.scales[index] = entities.scales[last];
+        entities.transforms[index] = entities.transforms[last];
+        entities.boundsMin[index] = entities.boundsMin[last];
+        entities.boundsMax[index] = entities.boundsMax[last];
+        entities.meshes[index] = entities.meshes[last];
+        entities.materials[index] = entities.materials[last];
+        entities.poses[index] = entities.poses[last];
+        entities.palettes[index] = entities.palettes[last];
+        entities.visible[index] = entities.visible[last];
+        entities.dirty[index] = entities.dirty[last];
+        entities.ids[index] = entities.ids[last];
+        entityIndex[entities.ids[index]] = index;
+    }
+    entities.positions.pop_back();
+    entities.yaws.pop_back();
+    entities.scales.pop_back();
+    entities.transforms.pop_back();
+    entities.boundsMin.pop_back();
+    entities.boundsMax.pop_back();
+    entities.meshes.pop_back();
+    entities.materials.pop_back();
+    entities.poses.pop_back();
+    entities.palettes.pop_back();
+    entities.visible.pop_back();
+    entities.dirty.pop_back();
+    entities.ids.pop_back();
+
+    entityIndex[entity] = INVALID_INDEX;
+    freeIds.push_back(entity);
+    visibleList.clear();
+    revision++;
+}
+
+void Scene::setPosition(EntityId entity, const glm::vec3& position) {
+    revision++;
+    uint32_t index = entityIndex[entity];
+    entities.positions[index] = position;
+    entities.dirty[index] = 1;
+}
+
+void Scene::setYaw(EntityId entity, float yaw) {
+    revision++;
+    uint32_t index = entityIndex[entity];
+    entities.yaws[index] = yaw;
+    entities.dirty[index] = 1;
+}
+
+void Scene::setScale(EntityId entity, float scale) {
+    revision++;
+    uint32_t index = entityIndex[entity];
+    entities.scales[index] = scale;
+    entities.dirty[index] = 1;
+}
+
+void Scene::setPose(EntityId entity, uint32_t pose) {
+    revision++;
+    entities.poses[entityIndex[entity]] = pose;
+}
+
+void Scene::setPalette(EntityId entity, PaletteId palette) {
+    revision++;
+    entities.palettes[entityIndex[entity]] = palette;
+}
+
+PartTransforms& Scene::getPoseBuffer(uint32_t pose) {
+    while (poseBuffers.size() <= pose) {
+        poseBuffers.push_back(std::make_unique<PartTransforms>());
+    }
+    return *poseBuffers[pose];
+}
+
+void Scene::updateTransforms() {
+    PROFILE_FUNCTION();
+
+    size_t count = entities.ids.size();
+    for (size_t i = 0; i < count; i++) {
+        if (!entities.dirty[i]) {
+            continue;
+        }
+        entities.dirty[i] = 0;
+
+        // 平移 * 绕y轴旋转 * 均匀缩放
+        float scale = entities.scales[i];
+        float c = std::cos(entities.yaws[i]);
+        float s = std::sin(entities.yaws[i]);
+        const glm::vec3& position = entities.positions[i];
+        glm::mat4& transform = entities.transforms[i];
+        transform[0] = glm::vec4(c * scale, 0.0f, -s * scale, 0.0f);
+        transform[1] = glm::vec4(0.0f, scale, 0.0f, 0.0f);
+        transform[2] = glm::vec4(s * scale, 0.0f, c * scale, 0.0f);
+        transform[3] = glm::vec4(position, 1.0f);
+
+        // 局部包围盒的中心按矩阵变换，半边长按旋转矩阵的绝对值变换
+        const Model& mesh = meshes[entities.meshes[i]];
+        glm::vec3 center = (mesh.boundsMin + mesh.boundsMax) * 0.5f;
+        glm::vec3 extent = (mesh.boundsMax - mesh.boundsMin) * 0.5f;
+        glm::vec3 worldCenter = position + glm::vec3(c * center.x + s * center.z, center.y,
+                                                     -s * center.x + c * center.z) * scale;
+        glm::vec3 worldExtent = glm::vec3(std::fabs(c) * extent.x + std::fabs(s) * extent.z, extent.y,
+                                          std::fabs(s) * extent.x + std::fabs(c) * extent.z) * scale;
+        entities.boundsMin[i] = worldCenter - worldExtent;
+        entities.boundsMax[i] = worldCenter + worldExtent;
+    }
+}
+
+size_t Scene::cull(const glm::mat4& viewProjection) {
+    PROFILE_FUNCTION();
+
+    // 从投影矩阵的行提取6个视锥平面（法线朝内）
+    glm::vec4 rows[4];
+    for (int r = 0; r < 4; r++) {
+        rows[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+    }
+    glm::vec4 planes[6] = {rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1],
+                           rows[3] - rows[1], rows[3] + rows[2], rows[3] - rows[2]};
+
+    size_t count = entities.ids.size();
+    visibleList.clear();
+    visibleList.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        glm::vec3 center = (entities.boundsMin[i] + entities.boundsMax[i]) * 0.5f;
+        glm::vec3 extent = (entities.boundsMax[i] - entities.boundsMin[i]) * 0.5f;
+        bool inside = true;
+        for (const glm::vec4& plane : planes) {
+            float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+            float radius = std::fabs(plane.x) * extent.x + std::fabs(plane.y) * extent.y +
+                           std::fabs(plane.z) * extent.z;
+            inside = inside && distance + radius >= 0.0f;
+        }
+        entities.visible[i] = inside ? 1 : 0;
+        if (inside) {
+            visibleList.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return visibleList.size();
+}
+
+void Scene::submit(RenderQueue& queue, Shader& shader, const glm::vec3& viewPosition) {
+    PROFILE_FUNCTION();
+
+    materials.bind();
+    paletteAtlas.bind();
+    for (uint32_t index : visibleList) {
+        glm::vec3 center = (entities.boundsMin[index] + entities.boundsMax[index]) * 0.5f;
+        uint32_t pose = entities.poses[index];
+        PaletteId palette = entities.palettes[index];
+        RenderQueue::Draw draw;
+        draw.program = &shader;
+        draw.material = entities.materials[index];
+        draw.mesh = &meshes[entities.meshes[index]];
+        draw.palette = palette != NO_PALETTE ? palette : meshPalettes[entities.meshes[index]];
+        draw.transform = &entities.transforms[index];
+        draw.pose = pose < poseBuffers.size() ? poseBuffers[pose].get() : nullptr;
+        queue.push(RenderQueue::Pass::Opaque, entities.meshes[index],
+                   glm::length(center - viewPosition), draw);
+    }
+}
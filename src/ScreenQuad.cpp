@@ -0,0 +1,51 @@
+#include "ScreenQuad.h"
+#include "MemoryTracker.h"
+#include "RenderStats.h"
+#include "GLState.h"
+#include "Diagnostics.h"
+#include <GL/glew.h>
+
+namespace {
+
+// 两个三角形：位置(x, y)，纹理坐标(u, v)
+const float QUAD_VERTICES[] = {
+    -1.0f,  1.0f,  0.0f, 1.0f,
+    -1.0f, -1.0f,  0.0f, 0.0f,
+     1.0f, -1.0f,  1.0f, 0.0f,
+    -1.0f,  1.0f,  0.0f, 1.0f,
+     1.0f, -1.0f,  1.0f, 0.0f,
+     1.0f,  1.0f,  1.0f, 1.0f
+};
+
+}
+
+ScreenQuad::ScreenQuad() {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    GLState::get().bindVertexArray(VAO);
+    GLState::get().bindBuffer(GL_ARRAY_BUFFER, VBO);
+    MemoryTracker::get().bufferData(GL_ARRAY_BUFFER, VBO, sizeof(QUAD_VERTICES), QUAD_VERTICES, GL_STATIC_DRAW,
+                                    MemoryCategory::Mesh, this, "ScreenQuad");
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+}
+
+ScreenQuad::~ScreenQuad() {
+    MemoryTracker::get().release(MemoryTracker::Resource::Buffer, VBO);
+    GLState::get().deleteVertexArray(VAO);
+    GLState::get().deleteBuffer(VBO);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+}
+
+void ScreenQuad::draw() const {
+    GLState::get().setEnabled(GL_DEPTH_TEST, false);
+    GLState::get().bindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    GL_CHECK("ScreenQuad::draw");
+    RenderStats& stats = RenderStats::get();
+    stats.drawCalls++;
+    stats.vertices += 6;
+}
@@ -1,6 +1,10 @@
 #include "Shader.h"
+#include "Profiler.h"
+#include "GLState.h"
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath) {
+    PROFILE_SCOPE("Shader::Shader");
+
     // 1. 从文件路径中获取顶点/片段着色器
     std::string vertexCode;
     std::string fragmentCode;
@@ -26,38 +30,49 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     catch(std::ifstream::failure& e) {
         std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
     }
+    // 2. 编译着色器
+    compile(vertexCode, fragmentCode);
+}
+
+Shader Shader::fromSource(const std::string& vertexCode, const std::string& fragmentCode) {
+    PROFILE_SCOPE("Shader::fromSource");
+    Shader shader;
+    shader.compile(vertexCode, fragmentCode);
+    return shader;
+}
+
+bool Shader::compile(const std::string& vertexCode, const std::string& fragmentCode) {
     const char* vShaderCode = vertexCode.c_str();
     const char* fShaderCode = fragmentCode.c_str();
-
-    // 2. 编译着色器
     unsigned int vertex, fragment;
 
     // 顶点着色器
     vertex = glCreateShader(GL_VERTEX_SHADER);
     glShaderSource(vertex, 1, &vShaderCode, NULL);
     glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX");
+    bool compiled = checkCompileErrors(vertex, "VERTEX");
 
     // 片段着色器
     fragment = glCreateShader(GL_FRAGMENT_SHADER);
     glShaderSource(fragment, 1, &fShaderCode, NULL);
     glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
+    compiled = checkCompileErrors(fragment, "FRAGMENT") && compiled;
 
     // 着色器程序
     ID = glCreateProgram();
     glAttachShader(ID, vertex);
     glAttachShader(ID, fragment);
     glLinkProgram(ID);
-    checkCompileErrors(ID, "PROGRAM");
+    compiled = checkCompileErrors(ID, "PROGRAM") && compiled;
 
     // 删除着色器，它们已经链接到程序中，不再需要了
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+    return compiled;
 }
 
 void Shader::use() {
-    glUseProgram(ID);
+    GLState::get().useProgram(ID);
 }
 
 void Shader::setBool(const std::string &name, bool value) const {
@@ -72,6 +87,10 @@ void Shader::setFloat(const std::string &name, float value) const {
     glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
 }
 
+void Shader::setVec2(const std::string &name, const glm::vec2 &value) const {
+    glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+}
+
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
     glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
 }
@@ -80,7 +99,14 @@ void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
     glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
-void Shader::checkCompileErrors(unsigned int shader, std::string type) {
+void Shader::bindUniformBlock(const std::string &name, unsigned int binding) const {
+    unsigned int index = glGetUniformBlockIndex(ID, name.c_str());
+    if (index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(ID, index, binding);
+    }
+}
+
+bool Shader::checkCompileErrors(unsigned int shader, std::string type) {
     int success;
     char infoLog[1024];
     if (type != "PROGRAM") {
@@ -99,4 +125,5 @@ void Shader::checkCompileErrors(unsigned int shader, std::string type) {
                       << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
         }
     }
-} 
\ No newline at end of file
+    return success != 0;
+}
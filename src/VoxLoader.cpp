@@ -0,0 +1,747 @@
+#include "VoxLoader.h"
+#include "ModelBuilder.h"
+#include "MeshCache.h"
+#include "JobSystem.h"
+#include "PartTransforms.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const int MAX_SCENE_DEPTH = 64;
+// .vox格式中单个模型每个维度最多256个体素（坐标为一个字节）
+const int MAX_MODEL_SIZE = 256;
+
+// 按小端序从映射区读取数据，越界时置ok为false
+struct ChunkReader {
+    const unsigned char* cursor;
+    const unsigned char* end;
+    bool ok;
+
+    ChunkReader(const unsigned char* begin, const unsigned char* end) : cursor(begin), end(end), ok(true) {}
+
+    bool has(size_t bytes) const {
+        return ok && static_cast<size_t>(end - cursor) >= bytes;
+    }
+
+    int32_t readInt() {
+        if (!has(4)) {
+            ok = false;
+            return 0;
+        }
+        int32_t value;
+        std::memcpy(&value, cursor, 4);
+        cursor += 4;
+        return value;
+    }
+
+    std::string_view readString() {
+        int32_t length = readInt();
+        if (length < 0 || !has(static_cast<size_t>(length))) {
+            ok = false;
+            return std::string_view();
+        }
+        std::string_view value(reinterpret_cast<const char*>(cursor), static_cast<size_t>(length));
+        cursor += length;
+        return value;
+    }
+
+    // 读取DICT，只保留需要的键
+    void readDict(std::unordered_map<std::string_view, std::string_view>* out) {
+        int32_t count = readInt();
+        for (int32_t i = 0; i < count && ok; i++) {
+            std::string_view key = readString();
+            std::string_view value = readString();
+            if (out != nullptr) {
+                (*out)[key] = value;
+            }
+        }
+    }
+};
+
+// "_t"的值形如"x y z"
+glm::vec3 parseTranslation(std::string_view text) {
+    glm::vec3 result(0.0f);
+    int component = 0;
+    size_t i = 0;
+    while (i < text.size() && component < 3) {
+        while (i < text.size() && text[i] == ' ') {
+            i++;
+        }
+        bool negative = i < text.size() && text[i] == '-';
+        if (negative) {
+            i++;
+        }
+        int value = 0;
+        while (i < text.size() && text[i] >= '0' && text[i] <= '9') {
+            value = value * 10 + (text[i] - '0');
+            i++;
+        }
+        result[component++] = static_cast<float>(negative ? -value : value);
+        while (i < text.size() && text[i] != ' ') {
+            i++;
+        }
+    }
+    return result;
+}
+
+// "_r"按字节编码旋转矩阵：bit0-1为第一行非零元素的列，bit2-3为第二行的列，bit4-6为三行的符号
+glm::mat3 parseRotation(std::string_view text) {
+    int bits = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            break;
+        }
+        bits = bits * 10 + (c - '0');
+    }
+    int column0 = bits & 3;
+    int column1 = (bits >> 2) & 3;
+    if (column0 > 2 || column1 > 2 || column0 == column1) {
+        return glm::mat3(1.0f);
+    }
+    int column2 = 3 - column0 - column1;
+    glm::mat3 rotation(0.0f);
+    // glm按列存储：rotation[列][行]
+    rotation[column0][0] = (bits & (1 << 4)) ? -1.0f : 1.0f;
+    rotation[column1][1] = (bits & (1 << 5)) ? -1.0f : 1.0f;
+    rotation[column2][2] = (bits & (1 << 6)) ? -1.0f : 1.0f;
+    return rotation;
+}
+
+// MagicaVoxel内置调色板：6x6x6色立方体（去掉黑色）加红、绿、蓝、灰四条10级色阶
+void fillDefaultPalette(uint32_t* palette) {
+    const uint32_t cubeLevels[6] = {0xff, 0xcc, 0x99, 0x66, 0x33, 0x00};
+    const uint32_t rampLevels[10] = {0xee, 0xdd, 0xbb, 0xaa, 0x88, 0x77, 0x55, 0x44, 0x22, 0x11};
+    int index = 0;
+    palette[index++] = 0;
+    for (uint32_t r : cubeLevels) {
+        for (uint32_t g : cubeLevels) {
+            for (uint32_t b : cubeLevels) {
+                if (r == 0 && g == 0 && b == 0) {
+                    continue;
+                }
+                palette[index++] = r | (g << 8) | (b << 16) | 0xff000000u;
+            }
+        }
+    }
+    for (int channel = 0; channel < 4; channel++) {
+        for (uint32_t level : rampLevels) {
+            uint32_t r = (channel == 0 || channel == 3) ? level : 0;
+            uint32_t g = (channel == 1 || channel == 3) ? level : 0;
+            uint32_t b = (channel == 2 || channel == 3) ? level : 0;
+            palette[index++] = r | (g << 8) | (b << 16) | 0xff000000u;
+        }
+    }
+}
+
+// 把count个任务交给JobSystem的共享线程池，parallel为false时在调用线程依次执行
+void parallelFor(size_t count, bool parallel, const std::function<void(size_t)>& task) {
+    size_t grain = parallel ? 1 : std::max<size_t>(1, count);
+    JobSystem::get().parallelFor(count, grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            task(i);
+        }
+    });
+}
+
+// 文件的修改时间（纳秒），取不到时为0
+int64_t fileModifiedTime(const std::string& path) {
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// MagicaVoxel的Z向上转换为Y向上
+inline glm::vec3 toYUp(const glm::vec3& v) {
+    return glm::vec3(v.x, v.z, -v.y);
+}
+
+}
+
+struct VoxFile::SceneNode {
+    enum Type { Transform, Group, Shape } type;
+    glm::mat3 rotation = glm::mat3(1.0f);
+    glm::vec3 translation = glm::vec3(0.0f);
+    bool hidden = false;
+    bool visited = false;
+    std::vector<int32_t> children;
+    std::vector<uint32_t> models;
+};
+
+VoxFile::VoxFile() : data(nullptr), dataSize(0), mapping(nullptr), mappingSize(0), modifiedTime(0) {
+    fillDefaultPalette(palette);
+}
+
+VoxFile::~VoxFile() {
+    close();
+}
+
+void VoxFile::close() {
+#ifndef _WIN32
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    std::vector<unsigned char>().swap(fileData);
+    data = nullptr;
+    dataSize = 0;
+    filePath.clear();
+    modifiedTime = 0;
+    models.clear();
+    instances.clear();
+    fillDefaultPalette(palette);
+}
+
+bool VoxFile::open(const std::string& path) {
+    PROFILE_FUNCTION();
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "ERROR::VOX::FILE_NOT_FOUND: " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        std::cerr << "ERROR::VOX::EMPTY_FILE: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    mappingSize = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "ERROR::VOX::MMAP_FAILED: " << path << std::endl;
+        mappingSize = 0;
+        return false;
+    }
+    mapping = mapped;
+    // 各模型会被不同线程随机访问，提前让内核预读
+    madvise(mapping, mappingSize, MADV_WILLNEED);
+    data = static_cast<const unsigned char*>(mapping);
+    dataSize = mappingSize;
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "ERROR::VOX::FILE_NOT_FOUND: " << path << std::endl;
+        return false;
+    }
+    fileData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = fileData.data();
+    dataSize = fileData.size();
+#endif
+
+    if (!parse()) {
+        std::cerr << "ERROR::VOX::PARSE_FAILED: " << path << std::endl;
+        close();
+        return false;
+    }
+    filePath = path;
+    modifiedTime = fileModifiedTime(path);
+    return true;
+}
+
+bool VoxFile::openMemory(const void* memory, size_t size) {
+    close();
+    data = static_cast<const unsigned char*>(memory);
+    dataSize = size;
+    if (!parse()) {
+        std::cerr << "ERROR::VOX::PARSE_FAILED: <memory>" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool VoxFile::parse() {
+    PROFILE_FUNCTION();
+
+    ChunkReader header(data, data + dataSize);
+    if (!header.has(8) || std::memcmp(data, "VOX ", 4) != 0) {
+        return false;
+    }
+    header.cursor += 8;
+
+    // MAIN块本身没有内容，子块依次排列
+    if (!header.has(12) || std::memcmp(header.cursor, "MAIN", 4) != 0) {
+        return false;
+    }
+    header.cursor += 4;
+    int32_t mainContent = header.readInt();
+    int32_t mainChildren = header.readInt();
+    if (mainContent < 0 || mainChildren < 0 ||
+        !header.has(static_cast<size_t>(mainContent) + static_cast<size_t>(mainChildren))) {
+        return false;
+    }
+    const unsigned char* cursor = header.cursor + mainContent;
+    const unsigned char* end = cursor + mainChildren;
+
+    std::unordered_map<int32_t, SceneNode> nodes;
+    glm::ivec3 pendingSize(0);
+
+    while (cursor < end) {
+        ChunkReader chunk(cursor, end);
+        if (!chunk.has(12)) {
+            return false;
+        }
+        const unsigned char* id = chunk.cursor;
+        chunk.cursor += 4;
+        int32_t contentSize = chunk.readInt();
+        int32_t childrenSize = chunk.readInt();
+        if (contentSize < 0 || childrenSize < 0 ||
+            !chunk.has(static_cast<size_t>(contentSize) + static_cast<size_t>(childrenSize))) {
+            return false;
+        }
+        ChunkReader content(chunk.cursor, chunk.cursor + contentSize);
+        cursor = chunk.cursor + contentSize + childrenSize;
+
+        if (std::memcmp(id, "SIZE", 4) == 0) {
+            pendingSize.x = content.readInt();
+            pendingSize.y = content.readInt();
+            pendingSize.z = content.readInt();
+            // 尺寸决定网格生成时稠密网格的大小，超出格式上限的文件视为损坏
+            for (int axis = 0; axis < 3; axis++) {
+                if (!content.ok || pendingSize[axis] < 1 || pendingSize[axis] > MAX_MODEL_SIZE) {
+                    return false;
+                }
+            }
+        }
+        else if (std::memcmp(id, "XYZI", 4) == 0) {
+            int32_t count = content.readInt();
+            // 每个体素4字节，必须完整落在本块内容中；之前必须有SIZE块
+            if (pendingSize.x == 0 || count < 0 || !content.has(static_cast<size_t>(count) * 4)) {
+                return false;
+            }
+            models.push_back(VoxModelView{pendingSize, content.cursor, static_cast<uint32_t>(count)});
+        }
+        else if (std::memcmp(id, "RGBA", 4) == 0) {
+            if (!content.has(256 * 4)) {
+                return false;
+            }
+            // 文件中第i个颜色对应索引i+1
+            palette[0] = 0;
+            for (int i = 0; i < 255; i++) {
+                std::memcpy(&palette[i + 1], content.cursor + i * 4, 4);
+            }
+        }
+        else if (std::memcmp(id, "nTRN", 4) == 0) {
+            int32_t nodeId = content.readInt();
+            SceneNode node;
+            node.type = SceneNode::Transform;
+            std::unordered_map<std::string_view, std::string_view> attributes;
+            content.readDict(&attributes);
+            node.hidden = attributes.count("_hidden") != 0 && attributes["_hidden"] == "1";
+            node.children.push_back(content.readInt());
+            content.readInt();                  // 保留字段
+            content.readInt();                  // 图层
+            int32_t frames = content.readInt();
+            for (int32_t i = 0; i < frames && content.ok; i++) {
+                std::unordered_map<std::string_view, std::string_view> frame;
+                content.readDict(&frame);
+                // 只使用第一帧
+                if (i == 0) {
+                    auto rotation = frame.find("_r");
+                    if (rotation != frame.end()) {
+                        node.rotation = parseRotation(rotation->second);
+                    }
+                    auto translation = frame.find("_t");
+                    if (translation != frame.end()) {
+                        node.translation = parseTranslation(translation->second);
+                    }
+                }
+            }
+            if (!content.ok) {
+                return false;
+            }
+            nodes[nodeId] = std::move(node);
+        }
+        else if (std::memcmp(id, "nGRP", 4) == 0) {
+            int32_t nodeId = content.readInt();
+            SceneNode node;
+            node.type = SceneNode::Group;
+            content.readDict(nullptr);
+            int32_t count = content.readInt();
+            for (int32_t i = 0; i < count && content.ok; i++) {
+                node.children.push_back(content.readInt());
+            }
+            if (!content.ok) {
+                return false;
+            }
+            nodes[nodeId] = std::move(node);
+        }
+        else if (std::memcmp(id, "nSHP", 4) == 0) {
+            int32_t nodeId = content.readInt();
+            SceneNode node;
+            node.type = SceneNode::Shape;
+            content.readDict(nullptr);
+            int32_t count = content.readInt();
+            for (int32_t i = 0; i < count && content.ok; i++) {
+                node.models.push_back(static_cast<uint32_t>(content.readInt()));
+                content.readDict(nullptr);
+            }
+            if (!content.ok) {
+                return false;
+            }
+            nodes[nodeId] = std::move(node);
+        }
+        // 其余块（PACK、MATL、LAYR、rOBJ、rCAM、NOTE、IMAP等）跳过
+    }
+
+    // 展开场景图，根节点为0号变换节点。场景图是一棵树，每个节点只能有一个父节点：
+    // 重复引用或成环的文件视为损坏，否则共享子节点会让展开的次数随深度指数增长
+    if (nodes.count(0) != 0) {
+        std::function<bool(int32_t, const glm::mat3&, const glm::vec3&, int)> visit =
+            [&](int32_t nodeId, const glm::mat3& rotation, const glm::vec3& translation, int depth) {
+            auto it = nodes.find(nodeId);
+            if (it == nodes.end()) {
+                return true;
+            }
+            SceneNode& node = it->second;
+            if (node.visited || depth > MAX_SCENE_DEPTH) {
+                return false;
+            }
+            node.visited = true;
+            if (node.type == SceneNode::Transform) {
+                if (node.hidden) {
+                    return true;
+                }
+                glm::mat3 childRotation = rotation * node.rotation;
+                glm::vec3 childTranslation = rotation * node.translation + translation;
+                for (int32_t child : node.children) {
+                    if (!visit(child, childRotation, childTranslation, depth + 1)) {
+                        return false;
+                    }
+                }
+            }
+            else if (node.type == SceneNode::Group) {
+                for (int32_t child : node.children) {
+                    if (!visit(child, rotation, translation, depth + 1)) {
+                        return false;
+                    }
+                }
+            }
+            else {
+                for (uint32_t model : node.models) {
+                    if (model < models.size()) {
+                        instances.push_back(VoxInstance{model, rotation, translation});
+                    }
+                }
+            }
+            return true;
+        };
+        if (!visit(0, glm::mat3(1.0f), glm::vec3(0.0f), 0)) {
+            return false;
+        }
+    }
+    else {
+        for (uint32_t i = 0; i < models.size(); i++) {
+            instances.push_back(VoxInstance{i, glm::mat3(1.0f), glm::vec3(0.0f)});
+        }
+    }
+
+    return !models.empty();
+}
+
+glm::vec3 VoxFile::paletteColor(unsigned char index) const {
+    uint32_t rgba = palette[index];
+    return glm::vec3(static_cast<float>(rgba & 0xff),
+                     static_cast<float>((rgba >> 8) & 0xff),
+                     static_cast<float>((rgba >> 16) & 0xff)) / 255.0f;
+}
+
+void VoxMesher::mesh(const VoxModelView& model, std::vector<Vertex>& out) {
+    PROFILE_FUNCTION();
+
+    std::vector<Vertex>().swap(out);
+    glm::ivec3 size = model.size;
+    if (size.x <= 0 || size.y <= 0 || size.z <= 0 || size.x > MAX_MODEL_SIZE || size.y > MAX_MODEL_SIZE ||
+        size.z > MAX_MODEL_SIZE || model.voxelCount == 0) {
+        return;
+    }
+
+    // 稠密网格存放调色板索引，0为空
+    size_t strideY = static_cast<size_t>(size.x);
+    size_t strideZ = strideY * static_cast<size_t>(size.y);
+    std::vector<unsigned char> grid(strideZ * static_cast<size_t>(size.z), 0);
+    for (uint32_t i = 0; i < model.voxelCount; i++) {
+        const unsigned char* voxel = model.xyzi + i * 4;
+        if (voxel[0] < size.x && voxel[1] < size.y && voxel[2] < size.z) {
+            grid[voxel[0] + voxel[1] * strideY + voxel[2] * strideZ] = voxel[3];
+        }
+    }
+
+    // 面的顺序与ModelBuilder::writeFace一致：+Z、-Z、+X、-X、+Y、-Y
+    const int neighbors[6][3] = {{0, 0, 1}, {0, 0, -1}, {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}};
+    auto exposed = [&](int x, int y, int z, int face) {
+        int nx = x + neighbors[face][0];
+        int ny = y + neighbors[face][1];
+        int nz = z + neighbors[face][2];
+        if (nx < 0 || ny < 0 || nz < 0 || nx >= size.x || ny >= size.y || nz >= size.z) {
+            return true;
+        }
+        return grid[nx + ny * strideY + nz * strideZ] == 0;
+    };
+
+    // 第一遍统计可见面数，按精确大小一次分配
+    size_t faces = 0;
+    for (int z = 0; z < size.z; z++) {
+        for (int y = 0; y < size.y; y++) {
+            for (int x = 0; x < size.x; x++) {
+                if (grid[x + y * strideY + z * strideZ] == 0) {
+                    continue;
+                }
+                for (int face = 0; face < ModelBuilder::FACES_PER_BOX; face++) {
+                    faces += exposed(x, y, z, face) ? 1 : 0;
+                }
+            }
+        }
+    }
+    out.resize(faces * ModelBuilder::VERTICES_PER_FACE);
+
+    // 模型中心（MagicaVoxel以尺寸的一半取整作为轴心）
+    glm::vec3 pivot = glm::vec3(size / 2);
+    Vertex* cursor = out.data();
+    for (int z = 0; z < size.z; z++) {
+        for (int y = 0; y < size.y; y++) {
+            for (int x = 0; x < size.x; x++) {
+                unsigned char index = grid[x + y * strideY + z * strideZ];
+                if (index == 0) {
+                    continue;
+                }
+                Box box{glm::vec3(x, y, z) + 0.5f - pivot, glm::vec3(1.0f), index};
+                for (int face = 0; face < ModelBuilder::FACES_PER_BOX; face++) {
+                    if (exposed(x, y, z, face)) {
+                        ModelBuilder::writeFace(box, face, cursor);
+                        cursor += ModelBuilder::VERTICES_PER_FACE;
+                    }
+                }
+            }
+        }
+    }
+}
+
+namespace {
+
+// 按场景图实例合并前的网格：被引用模型各自的顶点，以及每个实例在合并结果中的起始位置
+struct VoxSceneMesh {
+    std::vector<std::vector<Vertex>> meshes;
+    std::vector<size_t> offsets;
+
+    size_t total() const { return offsets.back(); }
+};
+
+// 只为被实例引用的模型生成网格，同一模型的多个实例共用一份
+void meshScene(const VoxFile& file, bool parallel, VoxSceneMesh& scene) {
+    const std::vector<VoxModelView>& views = file.getModels();
+    const std::vector<VoxInstance>& instances = file.getInstances();
+
+    std::vector<char> used(views.size(), 0);
+    for (const VoxInstance& instance : instances) {
+        used[instance.model] = 1;
+    }
+    scene.meshes.assign(views.size(), std::vector<Vertex>());
+    parallelFor(views.size(), parallel, [&](size_t i) {
+        if (used[i]) {
+            VoxMesher::mesh(views[i], scene.meshes[i]);
+        }
+    });
+
+    scene.offsets.assign(instances.size() + 1, 0);
+    for (size_t i = 0; i < instances.size(); i++) {
+        scene.offsets[i + 1] = scene.offsets[i] + scene.meshes[instances[i].model].size();
+    }
+}
+
+// 把每个实例变换到场景坐标后写入dst（至少total()个顶点），同时求包围盒
+void writeInstances(const VoxFile& file, const VoxSceneMesh& scene, float voxelSize, bool parallel, Vertex* dst,
+                    glm::vec3& meshMin, glm::vec3& meshMax) {
+    const std::vector<VoxInstance>& instances = file.getInstances();
+    std::vector<glm::vec3> instanceMin(instances.size(), glm::vec3(0.0f));
+    std::vector<glm::vec3> instanceMax(instances.size(), glm::vec3(0.0f));
+    parallelFor(instances.size(), parallel, [&](size_t i) {
+        const VoxInstance& instance = instances[i];
+        const std::vector<Vertex>& src = scene.meshes[instance.model];
+        Vertex* out = dst + scene.offsets[i];
+        // 镜像变换会翻转三角形绕序
+        bool flip = glm::determinant(instance.rotation) < 0.0f;
+        // 场景中的每个实例是一个部件，超出部件数的实例归入根部件
+        unsigned int part = i < PartTransforms::MAX_PARTS ? static_cast<unsigned int>(i) : 0;
+        glm::vec3 lo(0.0f), hi(0.0f);
+        for (size_t v = 0; v < src.size(); v++) {
+            size_t target = v;
+            if (flip && v % 3 != 0) {
+                target = v + (v % 3 == 1 ? 1 : -1);
+            }
+            Vertex& vertex = out[target];
+            vertex.Position = toYUp(instance.rotation * src[v].Position + instance.translation) * voxelSize;
+            vertex.Normal = toYUp(instance.rotation * src[v].Normal);
+            vertex.Color = src[v].Color;
+            vertex.Part = static_cast<uint8_t>(part);
+            vertex.Material = src[v].Material;
+            vertex.Padding = 0;
+            lo = v == 0 ? vertex.Position : glm::min(lo, vertex.Position);
+            hi = v == 0 ? vertex.Position : glm::max(hi, vertex.Position);
+        }
+        instanceMin[i] = lo;
+        instanceMax[i] = hi;
+    });
+
+    bool first = true;
+    for (size_t i = 0; i < instances.size(); i++) {
+        if (scene.offsets[i + 1] == scene.offsets[i]) {
+            continue;
+        }
+        meshMin = first ? instanceMin[i] : glm::min(meshMin, instanceMin[i]);
+        meshMax = first ? instanceMax[i] : glm::max(meshMax, instanceMax[i]);
+        first = false;
+    }
+}
+
+// 由VoxFile重新生成合并后的顶点，失败时out为空
+void rebuildVertices(const VoxFile& file, float voxelSize, bool parallel, std::vector<Vertex>& out) {
+    std::vector<Vertex>().swap(out);
+    VoxSceneMesh scene;
+    meshScene(file, parallel, scene);
+    out.resize(scene.total());
+    glm::vec3 meshMin(0.0f), meshMax(0.0f);
+    writeInstances(file, scene, voxelSize, parallel, out.data(), meshMin, meshMax);
+}
+
+// GpuOnly模型的源数据：从磁盘打开的文件只记住路径、大小和修改时间，需要CPU顶点时重新读取；
+// 内存中的数据保留一份副本
+void setVoxSource(const VoxFile& file, Model& model, float voxelSize, bool parallel) {
+    if (!file.getPath().empty()) {
+        std::string path = file.getPath();
+        size_t size = file.getSize();
+        int64_t modifiedTime = file.getModifiedTime();
+        model.setSource([path, size, modifiedTime, voxelSize, parallel](std::vector<Vertex>& out) {
+            std::vector<Vertex>().swap(out);
+            VoxFile source;
+            if (!source.open(path)) {
+                return;
+            }
+            if (source.getSize() != size || source.getModifiedTime() != modifiedTime) {
+                // 文件已被修改，生成的顶点会与GPU上的网格不一致
+                std::cerr << "Warning: vox file changed since it was loaded, CPU vertices not rebuilt: " << path
+                          << std::endl;
+                return;
+            }
+            rebuildVertices(source, voxelSize, parallel, out);
+        }, path.capacity());
+        return;
+    }
+
+    auto data = std::make_shared<const std::vector<unsigned char>>(file.getData(), file.getData() + file.getSize());
+    model.setSource([data, voxelSize, parallel](std::vector<Vertex>& out) {
+        std::vector<Vertex>().swap(out);
+        VoxFile source;
+        if (source.openMemory(data->data(), data->size())) {
+            rebuildVertices(source, voxelSize, parallel, out);
+        }
+    }, data->size());
+}
+
+}
+
+bool VoxLoader::load(const std::string& path, Model& model, float voxelSize, bool parallel) {
+    VoxFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    return load(file, model, voxelSize, parallel);
+}
+
+bool VoxLoader::load(const VoxFile& file, Model& model, float voxelSize, bool parallel) {
+    PROFILE_FUNCTION();
+
+    model = Model();
+    model.residency = Model::defaultResidency;
+    // 顶点的颜色索引就是文件调色板的索引
+    for (int i = 0; i < 256; i++) {
+        model.palette.push_back(file.paletteColor(static_cast<unsigned char>(i)));
+    }
+    bool gpuOnly = model.residency == Model::Residency::GpuOnly;
+
+    // 缓存键由文件、体素尺寸和网格生成器版本决定
+    MeshCache* cache = MeshCache::getDefault();
+    uint64_t cacheKey = 0;
+    if (cache != nullptr) {
+        uint32_t versions[3] = {MeshCache::FORMAT_VERSION, MeshCache::MESHER_VERSION,
+                                static_cast<uint32_t>(sizeof(Vertex))};
+        cacheKey = MeshCache::hash(versions, sizeof(versions));
+        cacheKey = MeshCache::hash(&voxelSize, sizeof(voxelSize), cacheKey);
+        if (file.getModifiedTime() != 0) {
+            // 磁盘上的文件用大小、修改时间和抽样内容作为键，命中时不必读遍整个文件；
+            // 抽样部分用来发现修改时间精度不足（同一秒内改写）的情况
+            int64_t identity[2] = {static_cast<int64_t>(file.getSize()), file.getModifiedTime()};
+            cacheKey = MeshCache::hash(identity, sizeof(identity), cacheKey);
+            cacheKey = MeshCache::hashSampled(file.getData(), file.getSize(), cacheKey);
+        }
+        else {
+            // 内存中的数据没有修改时间，只能哈希全部内容
+            cacheKey = MeshCache::hashWords(file.getData(), file.getSize(), cacheKey);
+        }
+        if (cache->load(cacheKey, model)) {
+            if (gpuOnly) {
+                setVoxSource(file, model, voxelSize, parallel);
+            }
+            return true;
+        }
+    }
+
+    VoxSceneMesh scene;
+    meshScene(file, parallel, scene);
+    size_t total = scene.total();
+    if (total == 0) {
+        std::cerr << "Warning: vox file contains no visible voxels" << std::endl;
+        return false;
+    }
+
+    if (gpuOnly && cache == nullptr) {
+        // 直接写入映射的GPU缓冲，不保留合并后的CPU副本
+        Vertex* mapped = model.mapMesh(total);
+        if (mapped != nullptr) {
+            writeInstances(file, scene, voxelSize, parallel, mapped, model.boundsMin, model.boundsMax);
+            if (model.unmapMesh()) {
+                setVoxSource(file, model, voxelSize, parallel);
+                return true;
+            }
+        }
+    }
+
+    model.vertices.resize(total);
+    glm::vec3 meshMin(0.0f), meshMax(0.0f);
+    writeInstances(file, scene, voxelSize, parallel, model.vertices.data(), meshMin, meshMax);
+    if (cache != nullptr) {
+        cache->store(cacheKey, model.vertices.data(), total, meshMin, meshMax);
+    }
+    model.uploadMesh(model.vertices.data(), total, meshMin, meshMax);
+    if (gpuOnly) {
+        model.releaseCpuData();
+        setVoxSource(file, model, voxelSize, parallel);
+    }
+    return true;
+}
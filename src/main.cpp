@@ -3,13 +3,34 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <string>
 #include <vector>
 #include "Shader.h"
 #include "Camera.h"
 #include "Model.h"
 #include "Light.h"
 #include "Material.h"
+#include "GpuProfiler.h"
+#include "Profiler.h"
+#include "MemoryTracker.h"
+#include "VoxLoader.h"
+#include "ModelDescription.h"
+#include "MeshCache.h"
+#include "PartTransforms.h"
+#include "Animation.h"
+#include "BuiltinModels.h"
+#include "Scene.h"
+#include "RenderQueue.h"
+#include "GLState.h"
+#include "Diagnostics.h"
+#include "RenderTargetPool.h"
+#include "DynamicResolution.h"
+#include "FramePacer.h"
+#include "PostChain.h"
+#include "PaletteLut.h"
 
 // 相机
 Camera camera(15.0f);
@@ -18,21 +39,59 @@ Camera camera(15.0f);
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
+// F5：重新加载命令行指定的模型
+bool reloadRequested = false;
+// C：切换猫的毛色
+bool coatRequested = false;
+
+// 像素化的块大小（屏幕像素）
+const float PIXEL_SIZE = 4.0f;
+// P：切换调色板量化（关闭、PICO-8、PICO-8加有序抖动）
+enum PaletteMode {
+    PaletteOff,
+    PaletteQuantize,
+    PaletteDither,
+    PaletteModeCount
+};
+int paletteMode = PaletteOff;
+bool paletteRequested = false;
+// 抖动阈值的幅度
+const float DITHER_STRENGTH = 0.12f;
+// O：切换描边
+bool outlineRequested = false;
+// R：开关动态分辨率
+bool resolutionRequested = false;
+// 动态分辨率的目标帧耗时（60Hz）
+const double FRAME_BUDGET_MS = 1000.0 / 60.0;
+// N：开关按需渲染（相机、场景、动画、窗口尺寸和显示设置都没有变化时不重绘，等待事件）
+bool onDemand = true;
+bool onDemandRequested = false;
+// 空格：暂停/继续猫的动画（动画播放时每帧都要重绘）；默认开启按需渲染，动画也默认暂停，启动后即可空闲
+bool animationPaused = true;
+bool pauseRequested = false;
+// 窗口内容需要重新显示（如被遮挡后露出），按需渲染时用缓存的上一帧呈现
+bool presentRequested = false;
+// 按需渲染空闲时等待事件的超时（秒），超时后照常处理内存日志等定时任务
+const double IDLE_WAIT_SECONDS = 0.25;
+// 帧时间的上限，空闲等待之后的第一帧相机不会因等待的时长跳动
+const float MAX_DELTA_TIME = 0.1f;
+// V：切换交换间隔（垂直同步、自适应、不限制）
+bool swapModeRequested = false;
+
 // 错误回调函数
 void errorCallback(int error, const char* description) {
     std::cerr << "GLFW Error " << error << ": " << description << std::endl;
 }
 
-// OpenGL调试回调
-void GLAPIENTRY messageCallback(GLenum source, GLenum type, GLuint id,
-    GLenum severity, GLsizei length, const GLchar* message, const void* userParam) {
-    std::cerr << "GL CALLBACK: " << (type == GL_DEBUG_TYPE_ERROR ? "** GL ERROR **" : "") 
-              << " type = " << type << ", severity = " << severity 
-              << ", message = " << message << std::endl;
+// 窗口刷新回调
+void refreshCallback(GLFWwindow*) {
+    presentRequested = true;
 }
 
 // 处理键盘输入
 void processInput(GLFWwindow* window) {
+    PROFILE_FUNCTION();
+
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 
@@ -48,9 +107,120 @@ void processInput(GLFWwindow* window) {
         camera.ZoomIn(deltaTime);
     if (glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS)
         camera.ZoomOut(deltaTime);
+
+    // F12：导出CPU trace
+    static bool dumpKeyDown = false;
+    bool dumpPressed = glfwGetKey(window, GLFW_KEY_F12) == GLFW_PRESS;
+    if (dumpPressed && !dumpKeyDown) {
+        PROFILE_DUMP("cpu_trace.json");
+    }
+    dumpKeyDown = dumpPressed;
+
+    static bool reloadKeyDown = false;
+    bool reloadPressed = glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS;
+    if (reloadPressed && !reloadKeyDown) {
+        reloadRequested = true;
+    }
+    reloadKeyDown = reloadPressed;
+
+    static bool coatKeyDown = false;
+    bool coatPressed = glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS;
+    if (coatPressed && !coatKeyDown) {
+        coatRequested = true;
+    }
+    coatKeyDown = coatPressed;
+
+    static bool paletteKeyDown = false;
+    bool palettePressed = glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS;
+    if (palettePressed && !paletteKeyDown) {
+        paletteRequested = true;
+    }
+    paletteKeyDown = palettePressed;
+
+    static bool outlineKeyDown = false;
+    bool outlinePressed = glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS;
+    if (outlinePressed && !outlineKeyDown) {
+        outlineRequested = true;
+    }
+    outlineKeyDown = outlinePressed;
+
+    static bool resolutionKeyDown = false;
+    bool resolutionPressed = glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS;
+    if (resolutionPressed && !resolutionKeyDown) {
+        resolutionRequested = true;
+    }
+    resolutionKeyDown = resolutionPressed;
+
+    static bool onDemandKeyDown = false;
+    bool onDemandPressed = glfwGetKey(window, GLFW_KEY_N) == GLFW_PRESS;
+    if (onDemandPressed && !onDemandKeyDown) {
+        onDemandRequested = true;
+    }
+    onDemandKeyDown = onDemandPressed;
+
+    static bool pauseKeyDown = false;
+    bool pausePressed = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+    if (pausePressed && !pauseKeyDown) {
+        pauseRequested = true;
+    }
+    pauseKeyDown = pausePressed;
+
+    static bool swapModeKeyDown = false;
+    bool swapModePressed = glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS;
+    if (swapModePressed && !swapModeKeyDown) {
+        swapModeRequested = true;
+    }
+    swapModeKeyDown = swapModePressed;
+}
+
+// 按扩展名加载.vox或.model文件
+bool loadExtraModel(const std::string& path, Model& model) {
+    bool loaded = false;
+    if (path.size() > 6 && path.compare(path.size() - 6, 6, ".model") == 0) {
+        ModelDescription description;
+        loaded = description.loadFile(path);
+        if (loaded) {
+            model = description.build();
+        }
+    }
+    else {
+        loaded = VoxLoader::load(path, model, 0.1f);
+    }
+    if (loaded) {
+        std::cout << "Model loaded from " << path << " with " << model.vertexCount << " vertices" << std::endl;
+    }
+    return loaded;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    PROFILE_THREAD_NAME("main");
+
+    // 命令行：[模型文件] [--swap vsync|adaptive|uncapped] [--fps N] [--gl-debug off|async|sync]
+    std::string extraModelPath;
+    FramePacer::SwapMode swapMode = FramePacer::SwapMode::VSync;
+    double targetFps = 0.0;
+    Diagnostics::Level diagnosticsLevel = Diagnostics::defaultLevel();
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--swap" && i + 1 < argc) {
+            if (!FramePacer::parseSwapMode(argv[++i], swapMode)) {
+                std::cerr << "Warning: unknown swap mode " << argv[i] << ", using vsync" << std::endl;
+            }
+        }
+        else if (arg == "--fps" && i + 1 < argc) {
+            targetFps = std::atof(argv[++i]);
+        }
+        else if (arg == "--gl-debug" && i + 1 < argc) {
+            if (!Diagnostics::parseLevel(argv[++i], diagnosticsLevel)) {
+                std::cerr << "Warning: unknown GL debug level " << argv[i] << ", using "
+                          << Diagnostics::levelName(diagnosticsLevel) << std::endl;
+            }
+        }
+        else {
+            extraModelPath = arg;
+        }
+    }
+
     // 初始化GLFW
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
@@ -61,7 +231,8 @@ int main() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+    // 只有开启诊断时才请求调试上下文，部分驱动在调试上下文中会关闭优化
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, diagnosticsLevel != Diagnostics::Level::Off ? GL_TRUE : GL_FALSE);
 
     // 创建窗口
     GLFWwindow* window = glfwCreateWindow(800, 600, "3D Pixel Animals", nullptr, nullptr);
@@ -73,6 +244,12 @@ int main() {
 
     // 设置当前上下文
     glfwMakeContextCurrent(window);
+    glfwSetWindowRefreshCallback(window, refreshCallback);
+
+    // 交换间隔和帧率限制
+    FramePacer framePacer;
+    framePacer.setSwapMode(swapMode);
+    framePacer.setTargetFps(targetFps);
 
     // 初始化GLEW
     if (glewInit() != GLEW_OK) {
@@ -80,10 +257,8 @@ int main() {
         return -1;
     }
 
-    // 启用OpenGL调试输出
-    glEnable(GL_DEBUG_OUTPUT);
-    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-    glDebugMessageCallback(messageCallback, 0);
+    // GL诊断：调试输出和错误检查的级别
+    Diagnostics::get().setLevel(diagnosticsLevel);
 
     // 打印OpenGL版本信息
     std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
@@ -92,36 +267,242 @@ int main() {
     // 创建并编译着色器
     Shader shader("shaders/vertex.glsl", "shaders/fragment.glsl");
     std::cout << "Shader program created with ID: " << shader.ID << std::endl;
+    shader.bindUniformBlock("PartTransforms", PartTransforms::BINDING);
+    shader.bindUniformBlock("Materials", MaterialTable::BINDING);
+    shader.use();
+    shader.setInt("palette", PaletteAtlas::TEXTURE_UNIT);
+
+    // 模型上传后不需要CPU顶点副本
+    Model::defaultResidency = Model::Residency::GpuOnly;
+
+    // 生成过的网格缓存到磁盘，下次启动直接映射上传
+    MeshCache meshCache("mesh_cache");
+    MeshCache::setDefault(&meshCache);
+
+    // 场景：地面、猫和命令行指定的模型
+    Scene scene;
+    Scene::MaterialId groundMaterial =
+        scene.addMaterial(Material(glm::vec3(0.2f), glm::vec3(0.8f), glm::vec3(0.2f), 16.0f));
+    Scene::MaterialId catMaterial =
+        scene.addMaterial(Material(glm::vec3(0.3f), glm::vec3(0.8f), glm::vec3(0.5f), 32.0f));
 
     // 创建地面
-    Model ground = Model::createGround(10.0f, 10.0f, glm::vec3(0.4f, 0.8f, 0.4f));
+    Scene::MeshId groundMesh = scene.addMesh(Model::createGround(10.0f, 10.0f, glm::vec3(0.4f, 0.8f, 0.4f)));
+    scene.createEntity(groundMesh, groundMaterial, glm::vec3(0.0f, -0.5f, 0.0f));
     
     // 创建猫模型
-    Model cat = Model::createCat(glm::vec3(0.0f, 0.0f, 0.0f), 1.0f);
-    std::cout << "Cat model created with " << cat.vertices.size() << " vertices" << std::endl;
+    Scene::MeshId catMesh = scene.addMesh(Model::createCat(glm::vec3(0.0f, 0.0f, 0.0f), 1.0f));
+    const Model& cat = scene.getMesh(catMesh);
+    std::cout << "Cat model created with " << cat.vertexCount << " vertices ("
+              << cat.gpuMemoryBytes() / 1024 << " KB GPU, " << cat.cpuMemoryBytes() / 1024 << " KB CPU)" << std::endl;
+    Scene::EntityId catEntity = scene.createEntity(catMesh, catMaterial);
+    // 毛色只是调色板的另一行，网格和顶点缓冲不变
+    Scene::PaletteId catCoats[BuiltinModels::CatCoatCount];
+    catCoats[BuiltinModels::CatCoatGray] = scene.getMeshPalette(catMesh);
+    for (int coat = BuiltinModels::CatCoatGray + 1; coat < BuiltinModels::CatCoatCount; coat++) {
+        catCoats[coat] = scene.addPalette(BuiltinModels::catPalette(static_cast<BuiltinModels::CatCoat>(coat)));
+    }
+    int catCoat = BuiltinModels::CatCoatGray;
+    // 猫的部件动画，每帧只上传部件矩阵
+    AnimationSampler animation(Skeleton::createCat());
+    unsigned int idleClip = static_cast<unsigned int>(animation.addClip(AnimationClip::createCatIdle()));
+    scene.setPose(catEntity, 0);
+
+    // 命令行指定的.vox或.model模型，放在猫的右侧，底部贴地
+    // 模型的材质索引0为与猫相同的材质，.model中的color ... material 1~4依次为预定义的金、翡翠、珍珠、祖母绿
+    Scene::MaterialId extraMaterial =
+        scene.addMaterial(Material(glm::vec3(0.3f), glm::vec3(0.8f), glm::vec3(0.5f), 32.0f));
+    scene.addMaterial(Material::Gold());
+    scene.addMaterial(Material::Jade());
+    scene.addMaterial(Material::Pearl());
+    scene.addMaterial(Material::Emerald());
+    Scene::MeshId extraMesh = 0;
+    Scene::EntityId extraEntity = 0;
+    bool hasExtraModel = false;
+    auto placeExtraModel = [&](Model&& model) {
+        glm::vec3 position(2.5f - model.boundsMin.x, -model.boundsMin.y, 0.0f);
+        if (hasExtraModel) {
+            scene.setMesh(extraMesh, std::move(model));
+            scene.setPosition(extraEntity, position);
+        }
+        else {
+            extraMesh = scene.addMesh(std::move(model));
+            extraEntity = scene.createEntity(extraMesh, extraMaterial, position);
+            hasExtraModel = true;
+        }
+    };
+    {
+        Model extraModel;
+        if (!extraModelPath.empty() && loadExtraModel(extraModelPath, extraModel)) {
+            placeExtraModel(std::move(extraModel));
+        }
+    }
+    RenderQueue renderQueue;
+
+    // 后处理：场景先渲染到离屏帧缓冲，再经后处理链（像素化、描边、抖动、调色板量化）输出到屏幕
+    // 描边读取相邻像素，单独一个通道；抖动和量化合并进它前面的通道
+    // 离屏目标每帧从渲染目标池借用，拖动窗口时按取整后的尺寸复用，不会每帧重建
+    int width, height;
+    RenderTargetPool renderTargets;
+    PostChain postChain(renderTargets);
+    postChain.addStage("pixelate", PostChain::StageKind::Sample, "shaders/post/pixelate.glsl");
+    postChain.addStage("outline", PostChain::StageKind::Sample, "shaders/post/outline.glsl");
+    postChain.addStage("dither", PostChain::StageKind::Color, "shaders/post/dither.glsl");
+    postChain.addStage("quantize", PostChain::StageKind::Color, "shaders/post/quantize.glsl");
+    postChain.setEnabled("outline", false);
+    postChain.setEnabled("dither", false);
+    postChain.setEnabled("quantize", false);
+    postChain.setFloat("outline_threshold", 0.15f);
+    postChain.setVec3("outline_color", glm::vec3(0.1f, 0.1f, 0.15f));
+    postChain.setFloat("dither_strength", DITHER_STRENGTH);
+    postChain.setFloat("dither_scale", PIXEL_SIZE);
+    postChain.setInt("quantize_lut", PaletteLut::LUT_TEXTURE_UNIT);
+    postChain.setInt("quantize_palette", PaletteLut::PALETTE_TEXTURE_UNIT);
+    // 查找表在第一次打开量化时准备（有磁盘缓存时只需映射上传）
+    PaletteLut paletteLut;
 
-    // 启用深度测试
-    glEnable(GL_DEPTH_TEST);
+    // GPU计时
+    GpuProfiler gpuProfiler;
+    // 动态分辨率：GPU帧耗时超出预算时按像素块大小的约数降低场景分辨率
+    DynamicResolution dynamicResolution(static_cast<int>(PIXEL_SIZE), FRAME_BUDGET_MS);
+
+    // 每10秒输出一次内存用量
+    MemoryTracker::get().setLogInterval(10.0);
+
+    // 按需渲染的状态：上次绘制时的场景修改计数和窗口尺寸，以及缓存的上一帧
+    bool settingsChanged = true;
+    uint64_t drawnRevision = 0;
+    int drawnWidth = 0;
+    int drawnHeight = 0;
+    float animationTime = 0.0f;
+    RenderTargetPool::Target presentTarget;
+    auto presentCachedFrame = [&]() {
+        GLState::get().bindFramebuffer(0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, presentTarget.framebuffer->FBO);
+        glBlitFramebuffer(0, 0, presentTarget.width, presentTarget.height,
+                          0, 0, presentTarget.width, presentTarget.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    };
 
     // 主循环
     while (!glfwWindowShouldClose(window)) {
+        PROFILE_SCOPE("frame");
+
+        // 先等到下一帧的时间点，再处理事件和按键，输入尽量晚采样、紧接着更新相机
+        framePacer.waitForNextFrame();
+        {
+            PROFILE_SCOPE("pollEvents");
+            glfwPollEvents();
+        }
+        framePacer.markInput();
+
         // 计算帧时间
         float currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
+        deltaTime = std::min(currentFrame - lastFrame, MAX_DELTA_TIME);
         lastFrame = currentFrame;
 
         // 处理输入
         processInput(window);
+        if (reloadRequested) {
+            reloadRequested = false;
+            // 加载失败时保留旧模型
+            Model reloaded;
+            if (!extraModelPath.empty() && loadExtraModel(extraModelPath, reloaded)) {
+                placeExtraModel(std::move(reloaded));
+            }
+        }
+        if (coatRequested) {
+            coatRequested = false;
+            catCoat = (catCoat + 1) % BuiltinModels::CatCoatCount;
+            scene.setPalette(catEntity, catCoats[catCoat]);
+        }
+        if (paletteRequested) {
+            paletteRequested = false;
+            paletteMode = (paletteMode + 1) % PaletteModeCount;
+            if (paletteMode != PaletteOff && !paletteLut.isReady() && paletteLut.build(PaletteLut::createPico8())) {
+                std::cout << "Palette LUT " << (paletteLut.wasCached() ? "loaded" : "generated") << " in "
+                          << paletteLut.getBuildMs() << " ms" << std::endl;
+            }
+            bool quantize = paletteMode != PaletteOff && paletteLut.isReady();
+            postChain.setEnabled("quantize", quantize);
+            postChain.setEnabled("dither", quantize && paletteMode == PaletteDither);
+            postChain.setInt("quantize_lutSize", static_cast<int>(paletteLut.getSize()));
+            settingsChanged = true;
+        }
+        if (outlineRequested) {
+            outlineRequested = false;
+            postChain.setEnabled("outline", !postChain.isEnabled("outline"));
+            settingsChanged = true;
+        }
+        if (resolutionRequested) {
+            resolutionRequested = false;
+            dynamicResolution.setEnabled(!dynamicResolution.isEnabled());
+            std::cout << "Dynamic resolution " << (dynamicResolution.isEnabled() ? "on" : "off") << std::endl;
+            settingsChanged = true;
+        }
+        if (onDemandRequested) {
+            onDemandRequested = false;
+            onDemand = !onDemand;
+            std::cout << "On-demand rendering " << (onDemand ? "on" : "off") << std::endl;
+            settingsChanged = true;
+        }
+        if (swapModeRequested) {
+            swapModeRequested = false;
+            // 不支持自适应时setSwapMode会退回垂直同步，按请求的模式轮换，避免停在同一个模式
+            swapMode = static_cast<FramePacer::SwapMode>(
+                (static_cast<int>(swapMode) + 1) % static_cast<int>(FramePacer::SwapMode::Count));
+            framePacer.setSwapMode(swapMode);
+            std::cout << "Swap mode " << FramePacer::swapModeName(framePacer.getSwapMode()) << std::endl;
+        }
+        if (pauseRequested) {
+            pauseRequested = false;
+            animationPaused = !animationPaused;
+            // 暂停后再画一帧到缓存的目标，之后空闲时可以重新呈现
+            settingsChanged = true;
+        }
+        if (!animationPaused) {
+            animationTime += deltaTime;
+        }
+        MemoryTracker::get().update(currentFrame);
+
+        // 按需渲染：只在有变化时重绘；相机的标记每帧都要取出清除
+        glfwGetFramebufferSize(window, &width, &height);
+        bool cameraChanged = camera.ConsumeChanged();
+        bool continuous = !onDemand || !animationPaused;
+        bool redraw = continuous || settingsChanged || cameraChanged || scene.getRevision() != drawnRevision ||
+                      width != drawnWidth || height != drawnHeight || (presentRequested && !presentTarget.framebuffer);
+        if (!redraw) {
+            // 没有变化：窗口需要重新显示时呈现缓存的上一帧，否则跳过这一帧并等待事件
+            if (presentRequested) {
+                presentCachedFrame();
+                PROFILE_SCOPE("swap");
+                glfwSwapBuffers(window);
+            }
+            presentRequested = false;
+            framePacer.reset();
+            PROFILE_SCOPE("waitEvents");
+            glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+            continue;
+        }
+        settingsChanged = false;
+        presentRequested = false;
+        drawnRevision = scene.getRevision();
+        drawnWidth = width;
+        drawnHeight = height;
+
+        gpuProfiler.beginFrame();
+        gpuProfiler.beginPass("scene");
+
+        // 借用离屏目标（窗口尺寸除以动态分辨率的divisor），同时设置视口
+        RenderTargetPool::Target sceneTarget = renderTargets.acquire(
+            {dynamicResolution.scale(width), dynamicResolution.scale(height), GL_RGB, true});
+        sceneTarget.bind();
+        GLState::get().setEnabled(GL_DEPTH_TEST, true);
 
         // 清除颜色缓冲和深度缓冲
         glClearColor(0.7f, 0.9f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // 设置视口
-        int width, height;
-        glfwGetFramebufferSize(window, &width, &height);
-        glViewport(0, 0, width, height);
-
         // 激活着色器
         shader.use();
 
@@ -146,43 +527,75 @@ int main() {
         shader.setFloat("lights[0].linear", 0.014f);
         shader.setFloat("lights[0].quadratic", 0.0007f);
 
-        // 绘制地面
-        glm::mat4 groundModel = glm::mat4(1.0f);
-        groundModel = glm::translate(groundModel, glm::vec3(0.0f, -0.5f, 0.0f));
-        shader.setMat4("model", groundModel);
-        
-        // 设置地面材质
-        shader.setVec3("material.ambient", glm::vec3(0.2f));
-        shader.setVec3("material.diffuse", glm::vec3(0.8f));
-        shader.setVec3("material.specular", glm::vec3(0.2f));
-        shader.setFloat("material.shininess", 16.0f);
-        
-        ground.draw();
-
-        // 绘制猫
-        glm::mat4 catModel = glm::mat4(1.0f);
-        catModel = glm::translate(catModel, glm::vec3(0.0f, 0.0f, 0.0f));
-        shader.setMat4("model", catModel);
-        
-        // 设置猫的材质
-        shader.setVec3("material.ambient", glm::vec3(0.3f));
-        shader.setVec3("material.diffuse", glm::vec3(0.8f));
-        shader.setVec3("material.specular", glm::vec3(0.5f));
-        shader.setFloat("material.shininess", 32.0f);
-        
-        cat.draw();
-
-        // 检查OpenGL错误
-        GLenum err;
-        while ((err = glGetError()) != GL_NO_ERROR) {
-            std::cerr << "OpenGL error: " << err << std::endl;
-        }
-
-        // 交换缓冲并处理事件
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        // 更新猫的动画姿态
+        AnimationSampler::Instance catAnimation{idleClip, animationTime};
+        animation.evaluate(&catAnimation, 1);
+        scene.getPoseBuffer(0).set(animation.getInstancePose(0), BuiltinModels::CatPartCount);
+
+        // 剔除场景，可见实体经渲染队列排序后提交
+        scene.updateTransforms();
+        scene.cull(projection * view);
+        renderQueue.clear(100.0f);
+        scene.submit(renderQueue, shader, camera.Position);
+        renderQueue.sort();
+        renderQueue.submit();
+
+        gpuProfiler.endPass();
+        gpuProfiler.beginPass("post");
+
+        // 后处理链输出到屏幕；下一帧可能空闲时先输出到缓存的目标再复制到屏幕，之后不重绘也能重新呈现，
+        // 持续重绘（动画播放或关闭按需渲染）时直接输出到屏幕，省去一次整窗口的复制
+        glm::vec2 pixelBlock(PIXEL_SIZE / width, PIXEL_SIZE / height);
+        postChain.setVec2("pixelate_size", pixelBlock);
+        postChain.setVec2("outline_step", pixelBlock);
+        if (postChain.isEnabled("quantize")) {
+            paletteLut.bind();
+        }
+        if (presentTarget.framebuffer) {
+            renderTargets.release(presentTarget);
+            presentTarget = RenderTargetPool::Target();
+        }
+        if (!continuous) {
+            presentTarget = renderTargets.acquire({width, height, GL_RGB, false});
+            postChain.run(sceneTarget, presentTarget.framebuffer->FBO, width, height);
+            presentCachedFrame();
+        }
+        else {
+            postChain.run(sceneTarget, 0, width, height);
+        }
+        renderTargets.release(sceneTarget);
+        renderTargets.endFrame();
+
+        gpuProfiler.endPass();
+        gpuProfiler.endFrame();
+
+        // 场景阶段随分辨率缩放，后处理按窗口尺寸输出、耗时不变
+        if (dynamicResolution.update(gpuProfiler.getLastMs("scene"), gpuProfiler.getLastMs("post"))) {
+            std::cout << "Render scale 1/" << dynamicResolution.getDivisor() << " ("
+                      << dynamicResolution.getSmoothedMs() << " ms)" << std::endl;
+        }
+
+        // 取出异步调试消息（Sync级别时检查glGetError；Off时什么都不做）
+        Diagnostics::get().endFrame();
+
+        // 交换缓冲，记录从采样输入到交换完成的延迟
+        {
+            PROFILE_SCOPE("swap");
+            glfwSwapBuffers(window);
+        }
+        framePacer.markSwap();
     }
 
+    // 输出GPU计时结果
+    gpuProfiler.flush();
+    gpuProfiler.printSummary();
+    gpuProfiler.exportCsv("gpu_profile.csv");
+    gpuProfiler.exportTrace("gpu_trace.json");
+    framePacer.printSummary();
+    Diagnostics::get().printSummary();
+    PROFILE_DUMP("cpu_trace.json");
+    MemoryTracker::get().printSummary();
+
     // 清理资源
     glfwDestroyWindow(window);
     glfwTerminate();